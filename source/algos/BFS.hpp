@@ -3,38 +3,51 @@
 #include <queue>
 
 #include "search_algos_util.hpp"
+#include "search_observer.hpp"
+#include "search_workspace.hpp"
 
 
 namespace algos {
+    template<typename Node>
+    struct BFSQueItem {
+        const Node child;
+        const size_t my_index;
+    };
+
     template<
         std::equality_comparable Node,
         typename Neighboors,
         typename Predicate,
         typename Reconstructor = decltype(reconstruct_path<Node>),
+        typename Observer = NullSearchObserver,
         template<typename> typename QueueType = std::queue
     >
-    requires NeighboorsGetter<Neighboors, Node> && NodePredicate<Predicate, Node>
+    requires NeighboorsGetter<Neighboors, Node>
+        && NodePredicate<Predicate, Node>
+        && PathReconstructor<Reconstructor, Node>
+        && SearchObserver<Observer, Node>
     static NodePath<Node> BFSFindPath(
             const Node& from,
             const Predicate& is_searched,
             const Neighboors& get_neighboors,
-            const Reconstructor& reconstructor = reconstruct_path<Node>
+            const Reconstructor& reconstructor = reconstruct_path<Node>,
+            const Observer& observer = {}
     ) {
-        struct QueItem {
-            const Node child;
-            const size_t my_index;
-        };
-
-        QueueType<QueItem> que;
-        std::vector<ReconstructionItem<Node>> parents = { {from, 0} }; 
+        QueueType<BFSQueItem<Node>> que;
+        std::vector<ReconstructionItem<Node>> parents = { {from, 0} };
         que.push({ from, 0 });
+        observer.discovered(from);
+        observer.pushed(from, que.size());
         while (!que.empty()) {
             const auto& [current, my_index] = que.front();
+            // `current` stays in the queue until it is expanded, so sizes reported meanwhile leave it out
+            observer.popped(current, que.size() - 1);
+            observer.expanded(current);
 
             if (is_searched(current)) {
                 return reconstructor(current, parents);
             }
-            
+
             for (const Node& child : get_neighboors(current)) {
                 auto this_node = rng::find(parents, child, &ReconstructionItem<Node>::child);
                 if (this_node != parents.end()) {
@@ -42,11 +55,121 @@ namespace algos {
                 }
                 que.push({ child, parents.size() });
                 parents.push_back({ child, my_index });
+                observer.discovered(child);
+                observer.pushed(child, que.size() - 1);
             }
 
             que.pop();
         }
         return {};
     }
-}
 
+    // Same search, but discovered nodes are tracked in a flat bitset addressed by `indexer`,
+    // so every node is checked in O(1) and the whole search is linear in the graph size.
+    template<
+        std::equality_comparable Node,
+        typename Neighboors,
+        typename Predicate,
+        typename Indexer,
+        typename Reconstructor = decltype(reconstruct_path<Node>),
+        typename Observer = NullSearchObserver,
+        template<typename> typename QueueType = std::queue
+    >
+    requires NeighboorsGetter<Neighboors, Node>
+        && NodePredicate<Predicate, Node>
+        && NodeIndexer<Indexer, Node>
+        && PathReconstructor<Reconstructor, Node>
+        && SearchObserver<Observer, Node>
+    static NodePath<Node> BFSFindPath(
+            const Node& from,
+            const Predicate& is_searched,
+            const Neighboors& get_neighboors,
+            const Indexer& indexer,
+            const Reconstructor& reconstructor = reconstruct_path<Node>,
+            const Observer& observer = {}
+    ) {
+        QueueType<BFSQueItem<Node>> que;
+        std::vector<bool> discovered(indexer.size(), false);
+        std::vector<ReconstructionItem<Node>> parents = { {from, 0} };
+        discovered[indexer(from)] = true;
+        que.push({ from, 0 });
+        observer.discovered(from);
+        observer.pushed(from, que.size());
+        while (!que.empty()) {
+            const auto& [current, my_index] = que.front();
+            observer.popped(current, que.size() - 1);
+            observer.expanded(current);
+
+            if (is_searched(current)) {
+                return reconstructor(current, parents);
+            }
+
+            for (const Node& child : get_neighboors(current)) {
+                const size_t slot = indexer(child);
+                if (discovered[slot]) {
+                    continue;
+                }
+                discovered[slot] = true;
+                que.push({ child, parents.size() });
+                parents.push_back({ child, my_index });
+                observer.discovered(child);
+                observer.pushed(child, que.size() - 1);
+            }
+
+            que.pop();
+        }
+        return {};
+    }
+
+    // Same as the indexed search, but it runs in `workspace` and allocates nothing once its buffers have grown
+    template<
+        std::equality_comparable Node,
+        typename Neighboors,
+        typename Predicate,
+        typename Indexer,
+        typename Reconstructor = decltype(reconstruct_path<Node>),
+        typename Observer = NullSearchObserver
+    >
+    requires NeighboorsGetter<Neighboors, Node>
+        && NodePredicate<Predicate, Node>
+        && PathReconstructor<Reconstructor, Node>
+        && SearchObserver<Observer, Node>
+    static NodePath<Node> BFSFindPath(
+            const Node& from,
+            const Predicate& is_searched,
+            const Neighboors& get_neighboors,
+            SearchWorkspace<Node, Indexer>& workspace,
+            const Reconstructor& reconstructor = reconstruct_path<Node>,
+            const Observer& observer = {}
+    ) {
+        auto& slots = workspace.slots;
+        auto& parents = workspace.parents;
+        slots.reset();
+        parents.clear();
+        slots.insert(from, 0);
+        parents.push_back({ from, 0 });
+        observer.discovered(from);
+        observer.pushed(from, parents.size());
+        for (size_t next = 0; next < parents.size(); ++next) {
+            // `parents` may grow below, so the node is copied out
+            const Node current = parents[next].child;
+            observer.popped(current, parents.size() - next - 1);
+            observer.expanded(current);
+
+            if (is_searched(current)) {
+                return reconstructor(current, parents);
+            }
+
+            for (const Node& child : get_neighboors(current)) {
+                if (slots.find(child) != npos) {
+                    continue;
+                }
+                slots.insert(child, parents.size());
+                parents.push_back({ child, next });
+                observer.discovered(child);
+                observer.pushed(child, parents.size() - next - 1);
+            }
+        }
+        return {};
+    }
+}
@@ -3,6 +3,7 @@
 #include <stack>
 
 #include "search_algos_util.hpp"
+#include "search_observer.hpp"
 
 
 namespace algos {
@@ -11,37 +12,45 @@ namespace algos {
         typename Neighboors,
         typename Predicate,
         typename Reconstructor = decltype(reconstruct_path<Node>),
+        typename Observer = NullSearchObserver,
         template<typename> typename StackType = std::stack
     >
-    requires NeighboorsGetter<Neighboors, Node> && NodePredicate<Predicate, Node>
+    requires NeighboorsGetter<Neighboors, Node> && NodePredicate<Predicate, Node> && SearchObserver<Observer, Node>
     static NodePath<Node> DFSFindPath(
             const Node& from,
             const Predicate& is_searched,
             const Neighboors& get_neighboors,
-            const Reconstructor& reconstructor = reconstruct_path<Node>
+            const Reconstructor& reconstructor = reconstruct_path<Node>,
+            const Observer& observer = {}
     ) {
         std::vector<ReconstructionItem<Node>> processed;
         StackType<ReconstructionItem<Node>> stack;
         stack.push({ from, 0 });
+        observer.pushed(from, stack.size());
         while (!stack.empty()) {
             const auto& [current, parent] = stack.top();
 
             if (rng::find(processed, current, &ReconstructionItem<Node>::child) != processed.end()) {
+                observer.popped(current, stack.size() - 1);
                 stack.pop();
                 continue;
             }
             
             const auto my_index = processed.size();
             processed.push_back({current, parent});
+            observer.discovered(current);
+            observer.expanded(current);
 
             if (is_searched(current)) {
                 return reconstructor(current, processed);
             }
 
             const auto& neighboors = get_neighboors(current);
+            observer.popped(current, stack.size() - 1);
             stack.pop();
             for (const Node& child : neighboors) {
                 stack.push({ child, my_index });
+                observer.pushed(child, stack.size());
             }
         }
         return {};
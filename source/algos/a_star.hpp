@@ -4,77 +4,201 @@
 #include <iterator>
 
 #include "search_algos_util.hpp"
+#include "search_observer.hpp"
+#include "search_workspace.hpp"
 
 
 namespace algos {
+    namespace detail {
+        template<
+            typename Node,
+            typename Neighboors,
+            typename Predicate,
+            typename Weight,
+            typename Heuristic,
+            typename Slots,
+            typename Reconstructor,
+            typename Observer = NullSearchObserver
+        >
+        NodePath<Node> a_star_search(
+                const Node& from,
+                const Predicate& is_searched,
+                const Neighboors& get_neighboors,
+                const Weight& get_weight,
+                const Heuristic& get_heuristic,
+                Slots& slots,
+                AStarBuffers<Node>& buffers,
+                const Reconstructor& reconstructor,
+                const Observer& observer = {}
+        ) {
+            auto& [estimates, open, parents] = buffers;
+            estimates.clear();
+            open.clear();
+            estimates.push_back({from, 0.0, double(get_heuristic(from)), 0});
+            slots.insert(from, 0);
+            open.push(0, estimates.front().heuristic);
+            observer.discovered(from);
+            observer.pushed(from, open.size());
+
+            while (!open.empty()) {
+                const auto current_index = open.pop();
+                const auto current = estimates[current_index];
+                observer.popped(current.node, open.size());
+                observer.expanded(current.node);
+
+                if (is_searched(current.node)) {
+                    parents.clear();
+                    parents.reserve(estimates.size());
+                    rng::transform(estimates, std::back_inserter(parents), [](const AStarRecord<Node>& item) {
+                        return ReconstructionItem{item.node, item.parent};
+                    });
+
+                    return reconstructor(current.node, parents);
+                }
+
+                for (const auto& neighboor : get_neighboors(current.node)) {
+                    const auto edge_path_weight = current.estimate + double(get_weight(current.node, neighboor));
+                    const auto index = slots.find(neighboor);
+                    if (index == npos) {
+                        const auto new_index = estimates.size();
+                        const auto heuristic = double(get_heuristic(neighboor));
+                        slots.insert(neighboor, new_index);
+                        estimates.push_back({neighboor, edge_path_weight, heuristic, current_index});
+                        open.push(new_index, edge_path_weight + heuristic);
+                        observer.discovered(neighboor);
+                        observer.pushed(neighboor, open.size());
+                        continue;
+                    }
+                    auto& existing = estimates[index];
+                    if (edge_path_weight < existing.estimate) {
+                        existing.estimate = edge_path_weight;
+                        existing.parent = current_index;
+                        observer.relaxed(current.node, neighboor);
+                        if (open.contains(index)) {
+                            open.decrease_key(index, edge_path_weight + existing.heuristic);
+                        }
+                    }
+                }
+            }
+            return {};
+        }
+
+        // Same search with buffers of its own
+        template<
+            typename Node,
+            typename Neighboors,
+            typename Predicate,
+            typename Weight,
+            typename Heuristic,
+            typename Slots,
+            typename Reconstructor,
+            typename Observer = NullSearchObserver
+        >
+        NodePath<Node> a_star_search(
+                const Node& from,
+                const Predicate& is_searched,
+                const Neighboors& get_neighboors,
+                const Weight& get_weight,
+                const Heuristic& get_heuristic,
+                Slots& slots,
+                const Reconstructor& reconstructor,
+                const Observer& observer = {}
+        ) {
+            AStarBuffers<Node> buffers;
+            return a_star_search(from, is_searched, get_neighboors, get_weight, get_heuristic, slots, buffers, reconstructor, observer);
+        }
+    }
+
     template<
         std::equality_comparable Node,
         typename Neighboors,
         typename Predicate,
         typename Weight,
         typename Heuristic,
-        typename Reconstructor = decltype(reconstruct_path<Node>)
+        typename Reconstructor = decltype(reconstruct_path<Node>),
+        typename Observer = NullSearchObserver
     >
-    requires NeighboorsGetter<Neighboors, Node> 
-        && WeightGetter<Weight, Node> 
+    requires NeighboorsGetter<Neighboors, Node>
+        && WeightGetter<Weight, Node>
         && NodePredicate<Predicate, Node>
         && HeuristicGetter<Heuristic, Node>
+        && PathReconstructor<Reconstructor, Node>
+        && SearchObserver<Observer, Node>
     static NodePath<Node> AStarFindPath(
             const Node& from,
             const Predicate& is_searched,
             const Neighboors& get_neighboors,
             const Weight& get_weight,
             const Heuristic& get_heuristic,
-            const Reconstructor& reconstructor = reconstruct_path<Node>
+            const Reconstructor& reconstructor = reconstruct_path<Node>,
+            const Observer& observer = {}
     ) {
-        struct LengthEstimate {
-            Node node;
-            double estimate; // shortest path from start currently known
-            size_t parent;
-            size_t my_index;
-        };
-        std::vector<LengthEstimate> estimates = { {from, 0.0, 0, 0} };
-        std::vector<size_t> unvisited_indices = { 0 };
-
-        while (!unvisited_indices.empty()) {
-            // TODO: maybe store heuristic in the LengthEstimate?
-            // Will save computation, loose some memory and weird cases
-            // where heuristic can change
-            auto current_it = rng::min_element(
-                unvisited_indices,
-                {},
-                [&](size_t idx) { return estimates[idx].estimate + get_heuristic(estimates[idx].node); }
-            );
-            auto current = estimates[*current_it];
-
-            if (is_searched(current.node)) {
-                std::vector<ReconstructionItem<Node>> parents;
-                parents.reserve(estimates.size());
-                rng::transform(estimates, std::back_inserter(parents), [](const LengthEstimate& item) {
-                    return ReconstructionItem{item.node, item.parent};
-                });
-
-                return reconstructor(current.node, parents);
-            }
+        LinearNodeSlots<Node> slots;
+        return detail::a_star_search(from, is_searched, get_neighboors, get_weight, get_heuristic, slots, reconstructor, observer);
+    }
 
-            unvisited_indices.erase(current_it);
+    // Node lookups go through `indexer` in O(1), making the search O(E log V)
+    template<
+        std::equality_comparable Node,
+        typename Neighboors,
+        typename Predicate,
+        typename Weight,
+        typename Heuristic,
+        typename Indexer,
+        typename Reconstructor = decltype(reconstruct_path<Node>),
+        typename Observer = NullSearchObserver
+    >
+    requires NeighboorsGetter<Neighboors, Node>
+        && WeightGetter<Weight, Node>
+        && NodePredicate<Predicate, Node>
+        && HeuristicGetter<Heuristic, Node>
+        && NodeIndexer<Indexer, Node>
+        && PathReconstructor<Reconstructor, Node>
+        && SearchObserver<Observer, Node>
+    static NodePath<Node> AStarFindPath(
+            const Node& from,
+            const Predicate& is_searched,
+            const Neighboors& get_neighboors,
+            const Weight& get_weight,
+            const Heuristic& get_heuristic,
+            const Indexer& indexer,
+            const Reconstructor& reconstructor = reconstruct_path<Node>,
+            const Observer& observer = {}
+    ) {
+        DenseNodeSlots<Node, Indexer> slots(indexer);
+        return detail::a_star_search(from, is_searched, get_neighboors, get_weight, get_heuristic, slots, reconstructor, observer);
+    }
 
-            const auto& neighboors = get_neighboors(current.node);
-            for (const auto& neighboor : neighboors) {
-                auto it = rng::find(estimates, neighboor, &LengthEstimate::node);
-                const auto edge_path_weight = current.estimate + get_weight(current.node, neighboor);
-                if (it == estimates.end()) {
-                    unvisited_indices.push_back(estimates.size());
-                    estimates.emplace_back(neighboor, edge_path_weight, current.my_index, estimates.size());
-                } else {
-                    if (edge_path_weight < it->estimate) {
-                        it->estimate = edge_path_weight;
-                        it->parent = current.my_index;
-                    }
-                }
-            }
-        }
-        return {};
+    // Same as the indexed search, but it runs in `workspace` and allocates nothing once its buffers have grown
+    template<
+        std::equality_comparable Node,
+        typename Neighboors,
+        typename Predicate,
+        typename Weight,
+        typename Heuristic,
+        typename Indexer,
+        typename Reconstructor = decltype(reconstruct_path<Node>),
+        typename Observer = NullSearchObserver
+    >
+    requires NeighboorsGetter<Neighboors, Node>
+        && WeightGetter<Weight, Node>
+        && NodePredicate<Predicate, Node>
+        && HeuristicGetter<Heuristic, Node>
+        && PathReconstructor<Reconstructor, Node>
+        && SearchObserver<Observer, Node>
+    static NodePath<Node> AStarFindPath(
+            const Node& from,
+            const Predicate& is_searched,
+            const Neighboors& get_neighboors,
+            const Weight& get_weight,
+            const Heuristic& get_heuristic,
+            SearchWorkspace<Node, Indexer>& workspace,
+            const Reconstructor& reconstructor = reconstruct_path<Node>,
+            const Observer& observer = {}
+    ) {
+        workspace.slots.reset();
+        return detail::a_star_search(
+            from, is_searched, get_neighboors, get_weight, get_heuristic, workspace.slots, workspace.a_star, reconstructor, observer
+        );
     }
 }
-
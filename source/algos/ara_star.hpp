@@ -0,0 +1,308 @@
+#pragma once
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include "search_algos_util.hpp"
+#include "search_observer.hpp"
+#include "indexed_heap.hpp"
+
+
+namespace algos {
+    // Inflation factors ε of ARA* iterations: the first one searches with `initial_epsilon`,
+    // every next one lowers it by `epsilon_step` down to 1, which is plain A*
+    struct AnytimeSchedule {
+        double initial_epsilon = 3.0;
+        double epsilon_step = 0.5;
+    };
+
+    // Anytime Repairing A* (Likhachev, Gordon, Thrun): A* with heuristics inflated by ε, repeated with
+    // lower ε until it reaches 1. Each iteration publishes a path costing at most ε times the optimum,
+    // nodes expanded earlier are not searched again unless a later iteration improves them.
+    //
+    // Work is done by `improve` calls with a budget each, so a caller can spend a few milliseconds per frame
+    // and show every better path as it arrives. A call interrupted by its budget continues on the next one.
+    // The heuristic has to be consistent for the reported bound to hold.
+    template<
+        std::equality_comparable Node,
+        typename Neighboors,
+        typename Predicate,
+        typename Weight,
+        typename Heuristic,
+        typename Indexer,
+        typename Observer = NullSearchObserver
+    >
+    requires NeighboorsGetter<Neighboors, Node>
+        && WeightGetter<Weight, Node>
+        && NodePredicate<Predicate, Node>
+        && HeuristicGetter<Heuristic, Node>
+        && NodeIndexer<Indexer, Node>
+        && SearchObserver<Observer, Node>
+    class AnytimeRepairingAStar {
+    public:
+        AnytimeRepairingAStar(
+                const Node& from,
+                Predicate is_searched,
+                Neighboors get_neighboors,
+                Weight get_weight,
+                Heuristic get_heuristic,
+                Indexer indexer,
+                const AnytimeSchedule& schedule = {},
+                Observer observer = {}
+        )
+            : m_is_searched(std::move(is_searched))
+            , m_get_neighboors(std::move(get_neighboors))
+            , m_get_weight(std::move(get_weight))
+            , m_get_heuristic(std::move(get_heuristic))
+            , m_indexer(std::move(indexer))
+            , m_observer(std::move(observer))
+            , m_records_by_slot(m_indexer.size(), npos)
+            , m_epsilon(std::max(schedule.initial_epsilon, 1.0))
+            , m_epsilon_step(schedule.epsilon_step) {
+            if (m_epsilon_step <= 0.0) {
+                throw std::logic_error("AnytimeRepairingAStar: epsilon has to decrease between iterations");
+            }
+            discover(from, 0.0, 0);
+            m_open.push(0, key(m_records.front()));
+            m_observer.pushed(from, m_open.size());
+        }
+
+        // Searches until the budget runs out or the path is proven optimal.
+        // Returns true if a better path was published during the call
+        template<typename OnExpand = EmptyUpdate<Node>>
+        bool improve(const SearchBudget& budget = {}, const OnExpand& on_expand = {}) {
+            detail::BudgetTracker tracker(budget);
+            bool improved = false;
+            while (!m_finished) {
+                while (!m_open.empty() && (m_goal == npos || m_open.top_priority() < m_records[m_goal].estimate)) {
+                    if (!tracker.take()) {
+                        return improved;
+                    }
+                    expand(m_open.pop(), on_expand);
+                }
+                improved = finish_iteration() || improved;
+            }
+            return improved;
+        }
+
+        // Set once the published path is optimal or there turned out to be none
+        bool is_finished() const {
+            return m_finished;
+        }
+
+        // Best path published so far, from the goal back to `from`. Empty before the first one
+        const NodePath<Node>& path() const {
+            return m_path;
+        }
+
+        // infinity before the first path
+        double path_cost() const {
+            return m_path_cost;
+        }
+
+        // Published path costs at most this many times the optimal one. Infinity before the first path
+        double suboptimality_bound() const {
+            return m_bound;
+        }
+
+        // inflation of the iteration in progress
+        double epsilon() const {
+            return m_epsilon;
+        }
+
+    private:
+        static constexpr double infinity = std::numeric_limits<double>::infinity();
+
+        struct Record {
+            Node node;
+            double estimate; // shortest path from start currently known
+            double heuristic; // computed once, when the node is discovered
+            size_t parent;
+            // iteration the node was last expanded in
+            size_t closed_in = npos;
+            bool is_goal = false;
+            // improved after its expansion in the current iteration, waits for the next one
+            bool is_inconsistent = false;
+        };
+
+        Predicate m_is_searched;
+        Neighboors m_get_neighboors;
+        Weight m_get_weight;
+        Heuristic m_get_heuristic;
+        Indexer m_indexer;
+        Observer m_observer;
+        std::vector<size_t> m_records_by_slot;
+        std::vector<Record> m_records;
+        IndexedHeap<double> m_open;
+        std::vector<size_t> m_inconsistent;
+        double m_epsilon;
+        double m_epsilon_step;
+        size_t m_iteration = 0;
+        // cheapest goal found so far
+        size_t m_goal = npos;
+        bool m_finished = false;
+        NodePath<Node> m_path;
+        double m_path_cost = infinity;
+        double m_bound = infinity;
+
+        double key(const Record& record) const {
+            return record.estimate + m_epsilon * record.heuristic;
+        }
+
+        size_t discover(const Node& node, double estimate, size_t parent) {
+            const auto index = m_records.size();
+            m_records_by_slot[m_indexer(node)] = index;
+            m_records.push_back({node, estimate, double(m_get_heuristic(node)), parent});
+            m_observer.discovered(node);
+            if (m_is_searched(node)) {
+                m_records.back().is_goal = true;
+                found_goal(index);
+            }
+            return index;
+        }
+
+        void found_goal(size_t index) {
+            if (m_goal == npos || m_records[index].estimate < m_records[m_goal].estimate) {
+                m_goal = index;
+            }
+        }
+
+        template<typename OnExpand>
+        void expand(size_t index, const OnExpand& on_expand) {
+            m_records[index].closed_in = m_iteration;
+            // records may be reallocated by discoveries below
+            const auto node = m_records[index].node;
+            const auto estimate = m_records[index].estimate;
+            m_observer.popped(node, m_open.size());
+            m_observer.expanded(node);
+            on_expand(node);
+            for (const auto& neighboor : m_get_neighboors(node)) {
+                const auto edge_path_weight = estimate + double(m_get_weight(node, neighboor));
+                const auto existing_index = m_records_by_slot[m_indexer(neighboor)];
+                if (existing_index == npos) {
+                    const auto new_index = discover(neighboor, edge_path_weight, index);
+                    m_open.push(new_index, key(m_records[new_index]));
+                    m_observer.pushed(neighboor, m_open.size());
+                    continue;
+                }
+                auto& existing = m_records[existing_index];
+                if (edge_path_weight >= existing.estimate) {
+                    continue;
+                }
+                existing.estimate = edge_path_weight;
+                existing.parent = index;
+                if (existing.is_goal) {
+                    found_goal(existing_index);
+                }
+                if (existing.closed_in != m_iteration) {
+                    const bool was_open = m_open.contains(existing_index);
+                    m_open.push_or_decrease(existing_index, key(existing));
+                    if (was_open) {
+                        m_observer.relaxed(node, neighboor);
+                    } else {
+                        m_observer.pushed(neighboor, m_open.size());
+                    }
+                } else if (!existing.is_inconsistent) {
+                    existing.is_inconsistent = true;
+                    m_inconsistent.push_back(existing_index);
+                }
+            }
+        }
+
+        // Publishes the path of the finished iteration and prepares the next one, returns true if the path got better
+        bool finish_iteration() {
+            if (m_goal == npos) {
+                // nothing is left to expand
+                m_finished = true;
+                return false;
+            }
+            const auto& goal = m_records[m_goal];
+            // parents along the way may have improved since the goal was reached,
+            // so the path can be cheaper than the goal's estimate
+            NodePath<Node> path = { goal.node };
+            double path_cost = 0.0;
+            for (auto index = m_goal; index != 0; index = m_records[index].parent) {
+                const auto& parent = m_records[m_records[index].parent].node;
+                path_cost += double(m_get_weight(parent, path.back()));
+                path.push_back(parent);
+            }
+            bool improved = false;
+            if (path_cost < m_path_cost) {
+                m_path = std::move(path);
+                m_path_cost = path_cost;
+                improved = true;
+            }
+
+            // a cheaper path would have to go through a node that is still waiting to be expanded
+            double lower_bound = goal.estimate;
+            for (size_t i = 0; i < m_records.size(); ++i) {
+                if (m_open.contains(i) || m_records[i].is_inconsistent) {
+                    lower_bound = std::min(lower_bound, m_records[i].estimate + m_records[i].heuristic);
+                }
+            }
+            m_bound = lower_bound > 0.0 ? std::min(m_epsilon, m_path_cost / lower_bound) : 1.0;
+            if (m_epsilon == 1.0 || m_bound <= 1.0) {
+                m_bound = 1.0;
+                m_finished = true;
+                return improved;
+            }
+
+            m_epsilon = std::max(m_epsilon - m_epsilon_step, 1.0);
+            ++m_iteration;
+            // keys of every waiting node change with ε, so the open list is rebuilt
+            std::vector<size_t> waiting = std::move(m_inconsistent);
+            m_inconsistent.clear();
+            for (size_t i = 0; i < m_records.size(); ++i) {
+                if (m_open.contains(i)) {
+                    waiting.push_back(i);
+                }
+            }
+            m_open.clear();
+            for (const auto index : waiting) {
+                m_open.push(index, key(m_records[index]));
+                // the others were open already, only their keys changed
+                if (m_records[index].is_inconsistent) {
+                    m_records[index].is_inconsistent = false;
+                    m_observer.pushed(m_records[index].node, m_open.size());
+                }
+            }
+            return improved;
+        }
+    };
+
+    // Best path ARA* publishes within `budget`, from the goal back to `from`. Empty if none was found in time
+    template<
+        std::equality_comparable Node,
+        typename Neighboors,
+        typename Predicate,
+        typename Weight,
+        typename Heuristic,
+        typename Indexer,
+        typename OnExpand = EmptyUpdate<Node>,
+        typename Observer = NullSearchObserver
+    >
+    requires NeighboorsGetter<Neighboors, Node>
+        && WeightGetter<Weight, Node>
+        && NodePredicate<Predicate, Node>
+        && HeuristicGetter<Heuristic, Node>
+        && NodeIndexer<Indexer, Node>
+        && SearchObserver<Observer, Node>
+    static NodePath<Node> ARAStarFindPath(
+            const Node& from,
+            const Predicate& is_searched,
+            const Neighboors& get_neighboors,
+            const Weight& get_weight,
+            const Heuristic& get_heuristic,
+            const Indexer& indexer,
+            const SearchBudget& budget = {},
+            const AnytimeSchedule& schedule = {},
+            const OnExpand& on_expand = {},
+            const Observer& observer = {}
+    ) {
+        AnytimeRepairingAStar search(from, is_searched, get_neighboors, get_weight, get_heuristic, indexer, schedule, observer);
+        search.improve(budget, on_expand);
+        return search.path();
+    }
+}
@@ -0,0 +1,276 @@
+#include "batch_search.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <optional>
+#include <random>
+#include <stdexcept>
+
+#include <maze/neighboorhood.hpp>
+
+#include "BFS.hpp"
+#include "DFS.hpp"
+#include "a_star.hpp"
+#include "ara_star.hpp"
+#include "bidirectional.hpp"
+#include "bitboard_bfs.hpp"
+#include "connected_components.hpp"
+#include "d_star_lite.hpp"
+#include "delta_stepping.hpp"
+#include "dijkstra.hpp"
+#include "hpa_star.hpp"
+#include "jump_point_search.hpp"
+
+
+namespace algos {
+    namespace detail {
+        inline constexpr size_t query_chunk = 8;
+
+        inline constexpr double octile_corner_cost = 1.4142135623730951;
+
+        struct BatchWeight {
+            const Maze* maze;
+            double corner_cost;
+            double slow_tile_cost;
+
+            double operator()(const Maze::Node& from, const Maze::Node& to) const {
+                const double distance = from.x != to.x && from.y != to.y ? corner_cost : 1.0;
+                return distance * (maze->get_cell(to) == MazeObject::slow ? slow_tile_cost : 1.0);
+            }
+        };
+
+        // Euclidean distance times the cheapest cost of a unit of it, so it stays admissible with cheap slow tiles and corners
+        struct BatchHeuristic {
+            double scale;
+
+            double operator()(const Maze::Node& from, const Maze::Node& to) const {
+                const auto dx = double(from.x) - double(to.x);
+                const auto dy = double(from.y) - double(to.y);
+                return scale * std::sqrt(dx * dx + dy * dy);
+            }
+        };
+
+        using BatchSlots = ReusableNodeSlots<Maze::Node, Maze::NodeIndexer>;
+
+        // search tables one worker keeps between its queries
+        template<typename Neighboors>
+        struct BatchWorkspace {
+            // forward slots also serve Dial and the bidirectional searches
+            SearchWorkspace<Maze::Node, Maze::NodeIndexer> forward;
+            BatchSlots backward;
+            // consecutive queries to the same goal continue its search instead of starting over
+            std::optional<DStarLite<Neighboors, BatchWeight, BatchHeuristic>> d_star_lite;
+            // level bitmaps are written by every query
+            std::optional<BitboardBFS> bitboard_bfs;
+
+            explicit BatchWorkspace(const Maze::NodeIndexer& indexer)
+                : forward(indexer)
+                , backward(indexer) {}
+        };
+
+        // everything shared by the queries of one batch, read only while they run
+        template<typename Neighboors>
+        struct BatchContext {
+            const Maze& maze;
+            const BatchSearchSettings& settings;
+            Neighboors get_neighboors;
+            BatchWeight get_weight;
+            Maze::NodeIndexer indexer;
+            BatchHeuristic heuristic;
+            double max_weight;
+            std::optional<JumpPointSearch> jump_point_search;
+            std::optional<HierarchicalPathfinder<Neighboors, BatchWeight>> hierarchical_pathfinder;
+            // queries between different regions are answered without a search
+            ConnectedComponents components;
+
+            double distance(const Maze::Node& from, const Maze::Node& to) const {
+                return heuristic(from, to);
+            }
+
+            double path_cost(const NodePath<Maze::Node>& path) const {
+                double cost = 0.0;
+                for (size_t i = 1; i < path.size(); ++i) {
+                    cost += get_weight(path[i], path[i - 1]);
+                }
+                return cost;
+            }
+        };
+
+        template<typename Neighboors>
+        static NodePath<Maze::Node> run_query(
+                BatchContext<Neighboors>& context,
+                BatchWorkspace<Neighboors>& workspace,
+                const PathQuery& query,
+                size_t query_index,
+                size_t& expanded
+        ) {
+            const auto& [from, to] = query;
+            const auto& get_neighboors = context.get_neighboors;
+            const auto& get_weight = context.get_weight;
+            const auto& indexer = context.indexer;
+            auto counting_searcher = [&](const Maze::Node& node) {
+                ++expanded;
+                return node == to;
+            };
+            auto counting_expander = [&](const Maze::Node&) {
+                ++expanded;
+            };
+            auto to_target = [&](const Maze::Node& node) {
+                return context.distance(node, to);
+            };
+            auto to_source = [&](const Maze::Node& node) {
+                return context.distance(node, from);
+            };
+            workspace.forward.slots.reset();
+            workspace.backward.reset();
+
+            switch (context.settings.algorithm) {
+                case EAlgorithm::BFS: {
+                    return BFSFindPath<Maze::Node>(from, counting_searcher, get_neighboors, workspace.forward);
+                }
+                case EAlgorithm::DFS: {
+                    return DFSFindPath<Maze::Node>(from, counting_searcher, get_neighboors);
+                }
+                case EAlgorithm::RandomDFS: {
+                    std::default_random_engine rengine(context.settings.seed + query_index);
+                    auto shuffled_neighboors = [&](const Maze::Node& node) {
+                        auto neighboors = get_neighboors(node);
+                        std::shuffle(neighboors.begin(), neighboors.end(), rengine);
+                        return neighboors;
+                    };
+                    return DFSFindPath<Maze::Node>(from, counting_searcher, shuffled_neighboors);
+                }
+                case EAlgorithm::Dijkstra: {
+                    return DijkstraFindPath(from, counting_searcher, get_neighboors, get_weight, workspace.forward);
+                }
+                case EAlgorithm::Dial: {
+                    const FixedPointWeight fixed_weight{get_weight, 100.0};
+                    return dial_search(
+                        from, counting_searcher, get_neighboors, fixed_weight, fixed_weight.to_fixed(context.max_weight),
+                        workspace.forward.slots, reconstruct_path<Maze::Node>
+                    );
+                }
+                case EAlgorithm::AStar: {
+                    return AStarFindPath(from, counting_searcher, get_neighboors, get_weight, to_target, workspace.forward);
+                }
+                case EAlgorithm::JPS: {
+                    if (!context.jump_point_search) {
+                        return AStarFindPath(from, counting_searcher, get_neighboors, get_weight, to_target, workspace.forward);
+                    }
+                    return context.jump_point_search->find_path(from, to, counting_expander);
+                }
+                case EAlgorithm::BidirectionalBFS: {
+                    return bidirectional_bfs(
+                        from, to, get_neighboors, SlotsRef(workspace.forward.slots), SlotsRef(workspace.backward),
+                        reconstruct_path<Maze::Node>, counting_expander
+                    );
+                }
+                case EAlgorithm::BidirectionalAStar: {
+                    return bidirectional_a_star(
+                        from, to, get_neighboors, get_weight, to_target, to_source,
+                        SlotsRef(workspace.forward.slots), SlotsRef(workspace.backward), reconstruct_path<Maze::Node>, counting_expander
+                    );
+                }
+                case EAlgorithm::HPAStar: {
+                    return context.hierarchical_pathfinder->find_path(from, to, to_target, counting_expander);
+                }
+                case EAlgorithm::DeltaStepping: {
+                    // queries already keep every worker busy
+                    util::ThreadPool single_thread(1);
+                    const auto tree = DeltaSteppingShortestPaths(from, get_neighboors, get_weight, indexer, context.settings.bucket_width, single_thread);
+                    const auto limit = tree.distance(to);
+                    expanded += size_t(rng::count_if(tree.distances, [&](double distance) {
+                        return distance <= limit;
+                    }));
+                    return tree.path_to(to);
+                }
+                case EAlgorithm::DStarLite: {
+                    if (!workspace.d_star_lite) {
+                        workspace.d_star_lite.emplace(context.maze, get_neighboors, get_weight, context.heuristic);
+                    }
+                    return workspace.d_star_lite->find_path(from, to, counting_expander);
+                }
+                case EAlgorithm::ARAStar: {
+                    // runs until the path is proven optimal, nothing waits for the early ones here
+                    AnytimeRepairingAStar search(from, Equals<Maze::Node>{to}, get_neighboors, get_weight, to_target, indexer);
+                    search.improve({}, counting_expander);
+                    return search.path();
+                }
+                case EAlgorithm::BitboardBFS: {
+                    if (!workspace.bitboard_bfs) {
+                        workspace.bitboard_bfs.emplace(context.maze, context.settings.allow_diagonals, context.settings.corners_require_adjacent);
+                    }
+                    return workspace.bitboard_bfs->find_path(from, to, counting_expander);
+                }
+            }
+            throw std::logic_error("Unknown algorithm!");
+        }
+
+        template<typename Neighboors>
+        static std::vector<QueryResult> find_paths_with(
+                const Maze& maze,
+                const BatchSearchSettings& settings,
+                std::span<const PathQuery> queries,
+                util::ThreadPool& pool,
+                const Neighboors& get_neighboors
+        ) {
+            const BatchWeight get_weight{&maze, settings.corner_cost, settings.slow_tile_cost};
+            // a corner move covers sqrt(2) of the distance
+            const double distance_cost = settings.allow_diagonals ? std::min(settings.corner_cost / octile_corner_cost, 1.0) : 1.0;
+            const double max_move_cost = settings.allow_diagonals ? std::max(settings.corner_cost, 1.0) : 1.0;
+            BatchContext<Neighboors> context{
+                maze, settings, get_neighboors, get_weight, maze.get_node_indexer(),
+                BatchHeuristic{std::min(settings.slow_tile_cost, 1.0) * distance_cost}, std::max(settings.slow_tile_cost, 1.0) * max_move_cost,
+                std::nullopt, std::nullopt, ConnectedComponents(maze, settings.allow_diagonals, settings.corners_require_adjacent)
+            };
+            // preprocessing is done here, so workers only read it
+            context.components.update();
+            if (settings.algorithm == EAlgorithm::JPS && settings.allow_diagonals && !maze.has_slow_tiles()
+                && settings.corner_cost == octile_corner_cost) {
+                context.jump_point_search.emplace(maze, settings.corners_require_adjacent, true);
+                context.jump_point_search->update_jump_distances();
+            }
+            if (settings.algorithm == EAlgorithm::HPAStar) {
+                context.hierarchical_pathfinder.emplace(maze, get_neighboors, get_weight);
+                context.hierarchical_pathfinder->entrance_count();
+            }
+
+            std::vector<QueryResult> results(queries.size());
+            // created by each worker on its first query, so unused workers allocate nothing
+            std::vector<std::optional<BatchWorkspace<Neighboors>>> workspaces(pool.size());
+            pool.for_each_chunk(queries.size(), query_chunk, [&](size_t worker, size_t begin, size_t end) {
+                auto& workspace = workspaces[worker];
+                if (!workspace) {
+                    workspace.emplace(context.indexer);
+                }
+                for (auto i = begin; i < end; ++i) {
+                    const auto& [from, to] = queries[i];
+                    // also covers endpoints outside of the maze or on a wall
+                    if (!context.components.connected(from, to)) {
+                        continue;
+                    }
+                    auto& [path, stats] = results[i];
+                    const auto start = std::chrono::steady_clock::now();
+                    path = run_query(context, *workspace, queries[i], i, stats.expanded_nodes);
+                    const auto finish = std::chrono::steady_clock::now();
+                    stats.milliseconds = std::chrono::duration<double, std::milli>(finish - start).count();
+                    stats.cost = context.path_cost(path);
+                }
+            });
+            return results;
+        }
+    }
+
+    std::vector<QueryResult> find_paths(
+            const Maze& maze,
+            const BatchSearchSettings& settings,
+            std::span<const PathQuery> queries,
+            util::ThreadPool& pool
+    ) {
+        // every search is compiled for each neighboorhood, so the choice is made here once
+        return neighboorhood::dispatch(settings.allow_diagonals, settings.corners_require_adjacent, [&](auto policy) {
+            return detail::find_paths_with(maze, settings, queries, pool, neighboorhood::Getter<decltype(policy)>{&maze});
+        });
+    }
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <span>
+#include <vector>
+
+#include <maze/maze.hpp>
+#include <util/thread_pool.hpp>
+
+#include "search_algorithm.hpp"
+#include "search_algos_util.hpp"
+
+
+namespace algos {
+    struct PathQuery {
+        Maze::Node from;
+        Maze::Node to;
+    };
+
+    struct QueryStats {
+        // nodes taken out of the open list, jump points for JPS and abstract nodes for HPA*
+        size_t expanded_nodes = 0;
+        // of the found path, 0 if there is none
+        double cost = 0.0;
+        double milliseconds = 0.0;
+    };
+
+    struct QueryResult {
+        // from `to` back to `from`, like reconstruct_path. Empty if there is no path
+        NodePath<Maze::Node> path;
+        QueryStats stats;
+    };
+
+    struct BatchSearchSettings {
+        EAlgorithm algorithm = EAlgorithm::AStar;
+        bool allow_diagonals = false;
+        bool corners_require_adjacent = true;
+        // side moves cost 1 and corner moves this, algvis passes the corner cost of its visual mode
+        double corner_cost = 1.4142135623730951;
+        // move costs are multiplied by this when entering a slow tile
+        double slow_tile_cost = 1.0;
+        double bucket_width = 1.0;
+        // RandomDFS of query `i` shuffles with `seed + i`, so results do not depend on thread timing
+        size_t seed = 0;
+    };
+
+    // Runs independent queries over one maze, spread across the pool's workers.
+    // Every worker keeps its own search tables and buffers and reuses them for each of its queries,
+    // preprocessing of JPS+ and HPA* is built once and then only read by all workers.
+    // Queries with an endpoint outside of the maze or on a wall get an empty path, and so do queries
+    // between regions no path connects. ConnectedComponents finds those before any search runs.
+    // JPS falls back to A* unless diagonals are allowed and the maze has no slow tiles, like in the apps.
+    // It also does when corners do not cost sqrt(2), the only costs its jumps are shortest for.
+    // D* Lite continues a worker's previous search when its goal is the same, so queries sharing a goal
+    // are cheaper next to each other. Its expanded node counts then depend on which worker got them.
+    std::vector<QueryResult> find_paths(
+        const Maze& maze,
+        const BatchSearchSettings& settings,
+        std::span<const PathQuery> queries,
+        util::ThreadPool& pool
+    );
+}
@@ -0,0 +1,380 @@
+#pragma once
+
+#include <concepts>
+#include <limits>
+#include <utility>
+
+#include "search_algos_util.hpp"
+#include "search_observer.hpp"
+#include "indexed_heap.hpp"
+
+
+// Searches growing from both ends at once and stopping where the two frontiers meet.
+// The graph is walked backwards from `to` with the same getters, so neighbourhoods must be symmetric:
+// `b` is a neighboor of `a` iff `a` is a neighboor of `b` (true for every maze neighbourhood).
+// Reconstructor gets the stitched path as a single parent chain from `from` to `to`.
+namespace algos {
+    namespace detail {
+        // pushes nodes from `index` up to the root of its search tree
+        template<typename Node, typename Records>
+        void append_parent_chain(std::vector<Node>& out, const Records& records, size_t index) {
+            out.push_back(records[index].node);
+            while (records[index].parent != index) {
+                index = records[index].parent;
+                out.push_back(records[index].node);
+            }
+        }
+
+        // both indices point at the node where the searches met
+        template<typename Node, typename Records, typename Reconstructor>
+        NodePath<Node> stitch_paths(
+                const Records& forward,
+                size_t forward_index,
+                const Records& backward,
+                size_t backward_index,
+                const Reconstructor& reconstructor
+        ) {
+            std::vector<Node> nodes;
+            append_parent_chain(nodes, forward, forward_index);
+            rng::reverse(nodes);
+            // meeting node is the first one of the backward chain as well
+            nodes.pop_back();
+            append_parent_chain(nodes, backward, backward_index);
+
+            std::vector<ReconstructionItem<Node>> parents;
+            parents.reserve(nodes.size());
+            for (size_t i = 0; i < nodes.size(); ++i) {
+                parents.push_back({nodes[i], i == 0 ? 0 : i - 1});
+            }
+            return reconstructor(nodes.back(), parents);
+        }
+
+        template<
+            typename Node,
+            typename Neighboors,
+            typename Slots,
+            typename Reconstructor,
+            typename OnExpand,
+            typename Observer = NullSearchObserver
+        >
+        NodePath<Node> bidirectional_bfs(
+                const Node& from,
+                const Node& to,
+                const Neighboors& get_neighboors,
+                Slots forward_slots,
+                Slots backward_slots,
+                const Reconstructor& reconstructor,
+                const OnExpand& on_expand,
+                const Observer& observer = {}
+        ) {
+            struct Record {
+                Node node;
+                size_t parent;
+            };
+            struct Side {
+                Slots slots;
+                std::vector<Record> records;
+                std::vector<size_t> frontier;
+            };
+            Side forward{std::move(forward_slots), { {from, 0} }, { 0 }};
+            Side backward{std::move(backward_slots), { {to, 0} }, { 0 }};
+            forward.slots.insert(from, 0);
+            backward.slots.insert(to, 0);
+            observer.discovered(from);
+            observer.pushed(from, size_t(1));
+            if (from == to) {
+                return stitch_paths<Node>(forward.records, 0, backward.records, 0, reconstructor);
+            }
+            observer.discovered(to);
+            observer.pushed(to, size_t(2));
+
+            // open list of the observer is both frontiers, nodes are taken out of them as they are expanded
+            size_t open_size = 2;
+            std::vector<size_t> next_frontier;
+            while (!forward.frontier.empty() && !backward.frontier.empty()) {
+                // expanding the smaller frontier keeps both searches roughly the same size
+                const bool is_forward = forward.frontier.size() <= backward.frontier.size();
+                auto& side = is_forward ? forward : backward;
+                const auto& other = is_forward ? backward : forward;
+
+                // Searches expand whole levels. While no meeting was found, balls of radius
+                // forward level and backward level are disjoint, so the first node reached
+                // by both searches lies on a shortest path.
+                next_frontier.clear();
+                for (const auto current_index : side.frontier) {
+                    const Node current = side.records[current_index].node;
+                    observer.popped(current, --open_size);
+                    observer.expanded(current);
+                    on_expand(current);
+                    for (const Node& child : get_neighboors(current)) {
+                        if (side.slots.find(child) != npos) {
+                            continue;
+                        }
+                        const auto child_index = side.records.size();
+                        side.slots.insert(child, child_index);
+                        side.records.push_back({child, current_index});
+                        next_frontier.push_back(child_index);
+                        observer.discovered(child);
+                        observer.pushed(child, ++open_size);
+
+                        const auto other_index = other.slots.find(child);
+                        if (other_index == npos) {
+                            continue;
+                        }
+                        if (is_forward) {
+                            return stitch_paths<Node>(forward.records, child_index, backward.records, other_index, reconstructor);
+                        }
+                        return stitch_paths<Node>(forward.records, other_index, backward.records, child_index, reconstructor);
+                    }
+                }
+                std::swap(side.frontier, next_frontier);
+            }
+            return {};
+        }
+
+        template<
+            typename Node,
+            typename Neighboors,
+            typename Weight,
+            typename HeuristicToTarget,
+            typename HeuristicToSource,
+            typename Slots,
+            typename Reconstructor,
+            typename OnExpand,
+            typename Observer = NullSearchObserver
+        >
+        NodePath<Node> bidirectional_a_star(
+                const Node& from,
+                const Node& to,
+                const Neighboors& get_neighboors,
+                const Weight& get_weight,
+                const HeuristicToTarget& to_target,
+                const HeuristicToSource& to_source,
+                Slots forward_slots,
+                Slots backward_slots,
+                const Reconstructor& reconstructor,
+                const OnExpand& on_expand,
+                const Observer& observer = {}
+        ) {
+            struct Record {
+                Node node;
+                double distance; // shortest path from the root of this side currently known
+                double potential;
+                size_t parent;
+                bool closed;
+            };
+            struct Side {
+                Slots slots;
+                std::vector<Record> records;
+                // ordered by distance + potential
+                IndexedHeap<double> open;
+            };
+            // Average of the two heuristics, negated for the backward search. Both sides then
+            // see the same consistent reduced edge costs, which makes the stopping rule below valid.
+            auto forward_potential = [&](const Node& node) {
+                return (double(to_target(node)) - double(to_source(node))) * 0.5;
+            };
+
+            Side forward{std::move(forward_slots), { {from, 0.0, forward_potential(from), 0, false} }, {}};
+            Side backward{std::move(backward_slots), { {to, 0.0, -forward_potential(to), 0, false} }, {}};
+            forward.slots.insert(from, 0);
+            backward.slots.insert(to, 0);
+            forward.open.push(0, forward.records.front().potential);
+            backward.open.push(0, backward.records.front().potential);
+            // open list of the observer is the open lists of both sides
+            auto open_size = [&] {
+                return forward.open.size() + backward.open.size();
+            };
+            observer.discovered(from);
+            observer.pushed(from, size_t(1));
+            observer.discovered(to);
+            observer.pushed(to, open_size());
+
+            auto best_length = from == to ? 0.0 : std::numeric_limits<double>::infinity();
+            size_t best_forward = from == to ? 0 : npos;
+            size_t best_backward = from == to ? 0 : npos;
+
+            while (!forward.open.empty() && !backward.open.empty()) {
+                // no path through unsettled nodes can be shorter than the sum of the two smallest keys
+                if (forward.open.top_priority() + backward.open.top_priority() >= best_length) {
+                    break;
+                }
+                const bool is_forward = forward.open.size() <= backward.open.size();
+                auto& side = is_forward ? forward : backward;
+                const auto& other = is_forward ? backward : forward;
+
+                const auto current_index = side.open.pop();
+                side.records[current_index].closed = true;
+                const auto current = side.records[current_index];
+                observer.popped(current.node, open_size());
+                observer.expanded(current.node);
+                on_expand(current.node);
+
+                for (const auto& neighboor : get_neighboors(current.node)) {
+                    // backward search walks edges against their direction
+                    const auto weight = is_forward
+                        ? double(get_weight(current.node, neighboor))
+                        : double(get_weight(neighboor, current.node));
+                    const auto distance = current.distance + weight;
+                    auto index = side.slots.find(neighboor);
+                    if (index == npos) {
+                        index = side.records.size();
+                        const auto potential = is_forward ? forward_potential(neighboor) : -forward_potential(neighboor);
+                        side.slots.insert(neighboor, index);
+                        side.records.push_back({neighboor, distance, potential, current_index, false});
+                        side.open.push(index, distance + potential);
+                        observer.discovered(neighboor);
+                        observer.pushed(neighboor, open_size());
+                    } else if (side.records[index].closed || distance >= side.records[index].distance) {
+                        continue;
+                    } else {
+                        auto& existing = side.records[index];
+                        existing.distance = distance;
+                        existing.parent = current_index;
+                        side.open.decrease_key(index, distance + existing.potential);
+                        observer.relaxed(current.node, neighboor);
+                    }
+
+                    const auto other_index = other.slots.find(neighboor);
+                    if (other_index == npos || distance + other.records[other_index].distance >= best_length) {
+                        continue;
+                    }
+                    best_length = distance + other.records[other_index].distance;
+                    best_forward = is_forward ? index : other_index;
+                    best_backward = is_forward ? other_index : index;
+                }
+            }
+
+            if (best_forward == npos) {
+                return {};
+            }
+            return stitch_paths<Node>(forward.records, best_forward, backward.records, best_backward, reconstructor);
+        }
+    }
+
+    // Bidirectional breadth-first search: path with the fewest edges between `from` and `to`.
+    // `on_expand` is called for every node taken from either frontier.
+    template<
+        std::equality_comparable Node,
+        typename Neighboors,
+        typename Reconstructor = decltype(reconstruct_path<Node>),
+        typename OnExpand = EmptyUpdate<Node>,
+        typename Observer = NullSearchObserver
+    >
+    requires NeighboorsGetter<Neighboors, Node>
+        && PathReconstructor<Reconstructor, Node>
+        && std::invocable<OnExpand, const Node&>
+        && SearchObserver<Observer, Node>
+    static NodePath<Node> BidirectionalBFSFindPath(
+            const Node& from,
+            const Node& to,
+            const Neighboors& get_neighboors,
+            const Reconstructor& reconstructor = reconstruct_path<Node>,
+            const OnExpand& on_expand = {},
+            const Observer& observer = {}
+    ) {
+        return detail::bidirectional_bfs(from, to, get_neighboors, LinearNodeSlots<Node>{}, LinearNodeSlots<Node>{}, reconstructor, on_expand, observer);
+    }
+
+    template<
+        std::equality_comparable Node,
+        typename Neighboors,
+        typename Indexer,
+        typename Reconstructor = decltype(reconstruct_path<Node>),
+        typename OnExpand = EmptyUpdate<Node>,
+        typename Observer = NullSearchObserver
+    >
+    requires NeighboorsGetter<Neighboors, Node>
+        && NodeIndexer<Indexer, Node>
+        && PathReconstructor<Reconstructor, Node>
+        && std::invocable<OnExpand, const Node&>
+        && SearchObserver<Observer, Node>
+    static NodePath<Node> BidirectionalBFSFindPath(
+            const Node& from,
+            const Node& to,
+            const Neighboors& get_neighboors,
+            const Indexer& indexer,
+            const Reconstructor& reconstructor = reconstruct_path<Node>,
+            const OnExpand& on_expand = {},
+            const Observer& observer = {}
+    ) {
+        using Slots = DenseNodeSlots<Node, Indexer>;
+        return detail::bidirectional_bfs(from, to, get_neighboors, Slots(indexer), Slots(indexer), reconstructor, on_expand, observer);
+    }
+
+    // Bidirectional A* with average potentials (Ikeda et al.).
+    // `to_target` estimates distance from a node to `to`, `to_source` - from `from` to a node.
+    // Both have to be consistent, like the ones used with AStarFindPath. Zero heuristics give bidirectional Dijkstra.
+    // `on_expand` is called for every node settled by either search.
+    template<
+        std::equality_comparable Node,
+        typename Neighboors,
+        typename Weight,
+        typename HeuristicToTarget,
+        typename HeuristicToSource,
+        typename Reconstructor = decltype(reconstruct_path<Node>),
+        typename OnExpand = EmptyUpdate<Node>,
+        typename Observer = NullSearchObserver
+    >
+    requires NeighboorsGetter<Neighboors, Node>
+        && WeightGetter<Weight, Node>
+        && HeuristicGetter<HeuristicToTarget, Node>
+        && HeuristicGetter<HeuristicToSource, Node>
+        && PathReconstructor<Reconstructor, Node>
+        && std::invocable<OnExpand, const Node&>
+        && SearchObserver<Observer, Node>
+    static NodePath<Node> BidirectionalAStarFindPath(
+            const Node& from,
+            const Node& to,
+            const Neighboors& get_neighboors,
+            const Weight& get_weight,
+            const HeuristicToTarget& to_target,
+            const HeuristicToSource& to_source,
+            const Reconstructor& reconstructor = reconstruct_path<Node>,
+            const OnExpand& on_expand = {},
+            const Observer& observer = {}
+    ) {
+        return detail::bidirectional_a_star(
+            from, to, get_neighboors, get_weight, to_target, to_source,
+            LinearNodeSlots<Node>{}, LinearNodeSlots<Node>{}, reconstructor, on_expand, observer
+        );
+    }
+
+    template<
+        std::equality_comparable Node,
+        typename Neighboors,
+        typename Weight,
+        typename HeuristicToTarget,
+        typename HeuristicToSource,
+        typename Indexer,
+        typename Reconstructor = decltype(reconstruct_path<Node>),
+        typename OnExpand = EmptyUpdate<Node>,
+        typename Observer = NullSearchObserver
+    >
+    requires NeighboorsGetter<Neighboors, Node>
+        && WeightGetter<Weight, Node>
+        && HeuristicGetter<HeuristicToTarget, Node>
+        && HeuristicGetter<HeuristicToSource, Node>
+        && NodeIndexer<Indexer, Node>
+        && PathReconstructor<Reconstructor, Node>
+        && std::invocable<OnExpand, const Node&>
+        && SearchObserver<Observer, Node>
+    static NodePath<Node> BidirectionalAStarFindPath(
+            const Node& from,
+            const Node& to,
+            const Neighboors& get_neighboors,
+            const Weight& get_weight,
+            const HeuristicToTarget& to_target,
+            const HeuristicToSource& to_source,
+            const Indexer& indexer,
+            const Reconstructor& reconstructor = reconstruct_path<Node>,
+            const OnExpand& on_expand = {},
+            const Observer& observer = {}
+    ) {
+        using Slots = DenseNodeSlots<Node, Indexer>;
+        return detail::bidirectional_a_star(
+            from, to, get_neighboors, get_weight, to_target, to_source,
+            Slots(indexer), Slots(indexer), reconstructor, on_expand, observer
+        );
+    }
+}
@@ -0,0 +1,49 @@
+#include "bitboard_bfs.hpp"
+
+#include <algorithm>
+
+
+namespace algos {
+    BitboardBFS::BitboardBFS(const Maze& maze, bool allow_diagonals, bool corners_require_adjacent)
+        : m_maze(maze)
+        , m_allow_diagonals(allow_diagonals)
+        , m_corners_require_adjacent(corners_require_adjacent) {}
+
+    void BitboardBFS::update_cells() {
+        if (m_revision == m_maze.revision && m_width == m_maze.width && m_height == m_maze.height) {
+            return;
+        }
+        m_revision = m_maze.revision;
+        m_width = m_maze.width;
+        m_height = m_maze.height;
+        m_words_per_row = PackedCells::words_per_row(m_width);
+        const auto layer_size = m_words_per_row * m_height;
+        m_free.assign(layer_size, 0);
+        m_visited.assign(layer_size, 0);
+        m_frontier.assign(layer_size, 0);
+        m_next.assign(layer_size, 0);
+        m_levels.assign(m_maze.cell_count(), 0);
+        m_empty_row.assign(m_words_per_row, 0);
+
+        if (m_maze.storage == EMazeStorage::packed) {
+            // padding bits past the row end have to stay clear
+            const auto tail_bits = m_width % word_bits;
+            const Word last_word = tail_bits == 0 ? ~Word(0) : (Word(1) << tail_bits) - 1;
+            for (size_t y = 0; y < m_height; ++y) {
+                const auto* walls = m_maze.packed.wall_row(y);
+                for (size_t i = 0; i < m_words_per_row; ++i) {
+                    const auto mask = i + 1 == m_words_per_row ? last_word : ~Word(0);
+                    m_free[y * m_words_per_row + i] = ~walls[i] & mask;
+                }
+            }
+            return;
+        }
+        for (size_t y = 0; y < m_height; ++y) {
+            for (size_t x = 0; x < m_width; ++x) {
+                if (m_maze.items[y * m_width + x] != MazeObject::wall) {
+                    set(m_free, {x, y});
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,233 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <maze/maze.hpp>
+#include <maze/packed_cells.hpp>
+
+#include "search_algos_util.hpp"
+#include "search_observer.hpp"
+
+
+namespace algos {
+    // Breadth-first search over Maze cells where a whole BFS level is one bitmap, one bit per cell,
+    // laid out like PackedCells rows. The next level is computed 64 cells at a time with shifts,
+    // ANDs and ORs against a bitmap of free cells, so open areas cost a few word operations per row
+    // instead of a queue push per cell. Every row next to the frontier is scanned whole, so it pays off
+    // on open mazes and loses on long thin corridors, where levels have only a few cells.
+    //
+    // Finds a path with the fewest moves, like BFSFindPath, slow tiles count as plain space.
+    // Side moves only, or sides and corners with the corner-cutting rule of Maze::get_sides_and_corners.
+    // The free cell bitmap is rebuilt when Maze::revision changes.
+    class BitboardBFS {
+    public:
+        using Word = PackedCells::Word;
+        static constexpr size_t word_bits = PackedCells::word_bits;
+
+        BitboardBFS(const Maze& maze, bool allow_diagonals, bool corners_require_adjacent = true);
+
+        bool allow_diagonals() const {
+            return m_allow_diagonals;
+        }
+
+        bool corners_require_adjacent() const {
+            return m_corners_require_adjacent;
+        }
+
+        // Rebuilds the free cell bitmap now rather than on the next query
+        void update_cells();
+
+        // Path from `to` back to `from`, like reconstruct_path.
+        // `on_expand` is called for every cell once its level is found, level by level.
+        // `observer` sees a whole level expanded at once, before cells of the next one are pushed.
+        template<typename OnExpand = EmptyUpdate<Maze::Node>, typename Observer = NullSearchObserver>
+        requires SearchObserver<Observer, Maze::Node>
+        NodePath<Maze::Node> find_path(
+                const Maze::Node& from,
+                const Maze::Node& to,
+                const OnExpand& on_expand = {},
+                const Observer& observer = {}
+        ) {
+            update_cells();
+            if (!m_maze.is_valid(from) || !m_maze.is_valid(to) || !is_set(m_free, from) || !is_set(m_free, to)) {
+                return {};
+            }
+            std::fill(m_visited.begin(), m_visited.end(), Word(0));
+            set(m_frontier, from);
+            set(m_visited, from);
+            m_levels[slot_of(from)] = 0;
+            on_expand(from);
+            m_frontier_rows.assign(1, from.y);
+            // cells of the current level not expanded yet and cells of the next one
+            size_t open_size = 1;
+            observer.discovered(from);
+            observer.pushed(from, open_size);
+
+            for (uint32_t level = 1; !is_set(m_visited, to); ++level) {
+                if constexpr (!std::same_as<Observer, NullSearchObserver>) {
+                    for_each_cell(m_frontier, m_frontier_rows, [&](const Maze::Node& node) {
+                        observer.popped(node, --open_size);
+                        observer.expanded(node);
+                    });
+                }
+                m_next_rows.clear();
+                // the next level can only reach rows next to the current one, both lists are sorted
+                size_t y = 0;
+                for (const auto frontier_row : m_frontier_rows) {
+                    y = std::max(y, frontier_row == 0 ? 0 : frontier_row - 1);
+                    for (const auto last = std::min(frontier_row + 2, m_height); y < last; ++y) {
+                        if (expand_row(y, level, on_expand, observer, open_size)) {
+                            m_next_rows.push_back(y);
+                        }
+                    }
+                }
+                // old frontier rows are cleared, so the buffer is empty outside of rows written next time
+                clear_rows(m_frontier, m_frontier_rows);
+                std::swap(m_frontier, m_next);
+                std::swap(m_frontier_rows, m_next_rows);
+                if (m_frontier_rows.empty()) {
+                    return {};
+                }
+            }
+            clear_rows(m_frontier, m_frontier_rows);
+
+            // every cell of a level has a neighboor one level closer to `from`
+            NodePath<Maze::Node> path = { to };
+            while (path.back() != from) {
+                const auto level = m_levels[slot_of(path.back())];
+                for (const auto& neighboor : neighboors(path.back())) {
+                    if (is_set(m_visited, neighboor) && m_levels[slot_of(neighboor)] + 1 == level) {
+                        path.push_back(neighboor);
+                        break;
+                    }
+                }
+            }
+            return path;
+        }
+
+    private:
+        const Maze& m_maze;
+        bool m_allow_diagonals;
+        bool m_corners_require_adjacent;
+        size_t m_width = 0;
+        size_t m_height = 0;
+        size_t m_words_per_row = 0;
+        // maze revision the free cell bitmap was built for, 0 if never built
+        uint64_t m_revision = 0;
+        std::vector<Word> m_free;
+        std::vector<Word> m_visited;
+        std::vector<Word> m_frontier;
+        std::vector<Word> m_next;
+        // BFS level of every visited cell, cells outside `m_visited` hold leftovers of older searches
+        std::vector<uint32_t> m_levels;
+        // stands for rows above and below the maze
+        std::vector<Word> m_empty_row;
+        // rows with frontier cells, ascending
+        std::vector<size_t> m_frontier_rows;
+        std::vector<size_t> m_next_rows;
+
+        size_t slot_of(const Maze::Node& node) const {
+            return node.y * m_width + node.x;
+        }
+
+        bool is_set(const std::vector<Word>& bitmap, const Maze::Node& node) const {
+            return (bitmap[node.y * m_words_per_row + node.x / word_bits] >> (node.x % word_bits) & 1) != 0;
+        }
+
+        void set(std::vector<Word>& bitmap, const Maze::Node& node) {
+            bitmap[node.y * m_words_per_row + node.x / word_bits] |= Word(1) << (node.x % word_bits);
+        }
+
+        // row `y` of a bitmap, rows outside of the maze are empty
+        const Word* row(const std::vector<Word>& bitmap, ptrdiff_t y) const {
+            return y < 0 || size_t(y) >= m_height ? m_empty_row.data() : bitmap.data() + size_t(y) * m_words_per_row;
+        }
+
+        // word `i` of a row moved one cell right, towards higher x
+        Word shifted_right(const Word* row, size_t i) const {
+            return row[i] << 1 | (i == 0 ? Word(0) : row[i - 1] >> (word_bits - 1));
+        }
+
+        // word `i` of a row moved one cell left, towards lower x
+        Word shifted_left(const Word* row, size_t i) const {
+            return row[i] >> 1 | (i + 1 == m_words_per_row ? Word(0) : row[i + 1] << (word_bits - 1));
+        }
+
+        // cells of word `i` in row `y` one move away from the frontier, walls are not filtered yet
+        Word expand(size_t y, size_t i) const {
+            const auto row_y = ptrdiff_t(y);
+            const auto* above = row(m_frontier, row_y - 1);
+            const auto* same = row(m_frontier, row_y);
+            const auto* below = row(m_frontier, row_y + 1);
+            const auto sides = above[i] | below[i] | shifted_right(same, i) | shifted_left(same, i);
+            if (!m_allow_diagonals) {
+                return sides;
+            }
+            if (!m_corners_require_adjacent) {
+                return sides | shifted_right(above, i) | shifted_left(above, i) | shifted_right(below, i) | shifted_left(below, i);
+            }
+            // a corner move passes by two cells which have to be free: the one in its start row and end column,
+            // and the one in its end row and start column
+            const auto* free_above = row(m_free, row_y - 1);
+            const auto* free_same = row(m_free, row_y);
+            const auto* free_below = row(m_free, row_y + 1);
+            const auto from_above = (shifted_right(above, i) & shifted_right(free_same, i) & free_above[i])
+                | (shifted_left(above, i) & shifted_left(free_same, i) & free_above[i]);
+            const auto from_below = (shifted_right(below, i) & shifted_right(free_same, i) & free_below[i])
+                | (shifted_left(below, i) & shifted_left(free_same, i) & free_below[i]);
+            return sides | from_above | from_below;
+        }
+
+        // Writes cells of row `y` reached at `level` into the next frontier, returns true if there are any
+        template<typename OnExpand, typename Observer>
+        bool expand_row(size_t y, uint32_t level, const OnExpand& on_expand, const Observer& observer, size_t& open_size) {
+            bool row_reached = false;
+            for (size_t i = 0; i < m_words_per_row; ++i) {
+                const auto reached = expand(y, i) & m_free[y * m_words_per_row + i] & ~m_visited[y * m_words_per_row + i];
+                m_next[y * m_words_per_row + i] = reached;
+                if (reached == 0) {
+                    continue;
+                }
+                row_reached = true;
+                m_visited[y * m_words_per_row + i] |= reached;
+                for (auto bits = reached; bits != 0; bits &= bits - 1) {
+                    const Maze::Node node{i * word_bits + size_t(std::countr_zero(bits)), y};
+                    m_levels[slot_of(node)] = level;
+                    on_expand(node);
+                    observer.discovered(node);
+                    observer.pushed(node, ++open_size);
+                }
+            }
+            return row_reached;
+        }
+
+        // every set cell of a bitmap in the given rows
+        template<typename Callback>
+        void for_each_cell(const std::vector<Word>& bitmap, const std::vector<size_t>& rows, const Callback& callback) const {
+            for (const auto y : rows) {
+                for (size_t i = 0; i < m_words_per_row; ++i) {
+                    for (auto bits = bitmap[y * m_words_per_row + i]; bits != 0; bits &= bits - 1) {
+                        callback(Maze::Node{i * word_bits + size_t(std::countr_zero(bits)), y});
+                    }
+                }
+            }
+        }
+
+        void clear_rows(std::vector<Word>& bitmap, const std::vector<size_t>& rows) {
+            for (const auto y : rows) {
+                std::fill_n(bitmap.begin() + ptrdiff_t(y * m_words_per_row), m_words_per_row, Word(0));
+            }
+        }
+
+        Maze::NeighboorList neighboors(const Maze::Node& node) const {
+            return m_allow_diagonals
+                ? m_maze.get_sides_and_corners(node, m_corners_require_adjacent)
+                : m_maze.get_cross_neighboors(node);
+        }
+    };
+}
@@ -0,0 +1,127 @@
+#include "connected_components.hpp"
+
+#include <array>
+#include <utility>
+
+#include <maze/neighboorhood.hpp>
+
+
+namespace algos {
+    ConnectedComponents::ConnectedComponents(const Maze& maze, bool allow_diagonals, bool corners_require_adjacent)
+        : m_maze(maze)
+        , m_allow_diagonals(allow_diagonals)
+        , m_corners_require_adjacent(corners_require_adjacent) {}
+
+    void ConnectedComponents::cells_changed(const std::vector<Maze::Node>& cells, uint64_t revision_before_edit) {
+        if (m_revision != revision_before_edit || m_maze.width != m_width || m_maze.height != m_height) {
+            return;
+        }
+        m_revision = m_maze.revision;
+        if (m_needs_rebuild) {
+            return;
+        }
+        for (const auto& cell : cells) {
+            if (m_parents[slot_of(cell)] != npos && m_maze.is_wall(cell)) {
+                m_needs_rebuild = true;
+                return;
+            }
+        }
+        // every labelled cell is free now, so opened cells only join regions
+        for (const auto& cell : cells) {
+            const auto slot = slot_of(cell);
+            if (m_parents[slot] == npos && !m_maze.is_wall(cell)) {
+                m_parents[slot] = slot;
+                ++m_region_count;
+                join_around(cell, false);
+            }
+        }
+    }
+
+    void ConnectedComponents::update() {
+        if (m_needs_rebuild || m_revision != m_maze.revision || m_width != m_maze.width || m_height != m_maze.height) {
+            rebuild();
+        }
+    }
+
+    size_t ConnectedComponents::label(const Maze::Node& node) {
+        update();
+        if (!m_maze.is_valid(node) || m_parents[slot_of(node)] == npos) {
+            return npos;
+        }
+        return root(slot_of(node));
+    }
+
+    size_t ConnectedComponents::region_count() {
+        update();
+        return m_region_count;
+    }
+
+    void ConnectedComponents::join(size_t first, size_t second) {
+        auto first_root = root(first);
+        auto second_root = root(second);
+        if (first_root == second_root) {
+            return;
+        }
+        if (m_ranks[first_root] < m_ranks[second_root]) {
+            std::swap(first_root, second_root);
+        }
+        m_parents[second_root] = first_root;
+        if (m_ranks[first_root] == m_ranks[second_root]) {
+            ++m_ranks[first_root];
+        }
+        --m_region_count;
+    }
+
+    void ConnectedComponents::join_around(const Maze::Node& node, bool preceding_only) {
+        const bool cuts_corners = m_allow_diagonals && !m_corners_require_adjacent;
+        // sides first, then corners. The first half of each lies above or left of the cell
+        constexpr std::array<std::pair<ptrdiff_t, ptrdiff_t>, 4> sides = {{ {-1, 0}, {0, -1}, {1, 0}, {0, 1} }};
+        constexpr std::array<std::pair<ptrdiff_t, ptrdiff_t>, 4> corners = {{ {-1, -1}, {1, -1}, {-1, 1}, {1, 1} }};
+        const size_t count = preceding_only ? 2 : 4;
+        const auto slot = slot_of(node);
+        auto join_with = [&](ptrdiff_t dx, ptrdiff_t dy) {
+            // coordinates are unsigned, so cells left of and above the maze wrap around and fail the checks too
+            const Maze::Node other{node.x + size_t(dx), node.y + size_t(dy)};
+            if (other.x < m_width && other.y < m_height && m_parents[slot_of(other)] != npos) {
+                join(slot, slot_of(other));
+            }
+        };
+        for (size_t i = 0; i < count; ++i) {
+            join_with(sides[i].first, sides[i].second);
+        }
+        if (cuts_corners) {
+            for (size_t i = 0; i < count; ++i) {
+                join_with(corners[i].first, corners[i].second);
+            }
+        }
+    }
+
+    void ConnectedComponents::rebuild() {
+        m_width = m_maze.width;
+        m_height = m_maze.height;
+        m_revision = m_maze.revision;
+        m_needs_rebuild = false;
+        m_region_count = 0;
+        m_parents.assign(m_maze.cell_count(), npos);
+        m_ranks.assign(m_maze.cell_count(), 0);
+        // cells after the current one are not labelled yet, so only ones above and left of it are joined
+        neighboorhood::detail::with_free_check(m_maze, [&](const auto& is_free) {
+            for (size_t y = 0; y < m_height; ++y) {
+                for (size_t x = 0; x < m_width; ++x) {
+                    if (!is_free(x, y)) {
+                        continue;
+                    }
+                    m_parents[slot_of({x, y})] = slot_of({x, y});
+                    ++m_region_count;
+                    join_around({x, y}, true);
+                }
+            }
+        });
+        // every cell points at its root, so queries until the next edit take one step
+        for (size_t slot = 0; slot < m_parents.size(); ++slot) {
+            if (m_parents[slot] != npos) {
+                m_parents[slot] = root(slot);
+            }
+        }
+    }
+}
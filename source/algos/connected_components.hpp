@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <maze/maze.hpp>
+
+#include "search_algos_util.hpp"
+
+
+namespace algos {
+    // Labels of regions of free cells: two cells share a label exactly when some path connects them,
+    // so a query between different regions is answered "no path" in O(1) instead of by searching
+    // everything reachable. Labels come from a union-find over the cells, built row by row:
+    // a free cell joins the cell left of it and the cells above that it can move to.
+    //
+    // Side moves only, or sides and corners with the corner-cutting rule of Maze::get_sides_and_corners.
+    // A corner move that needs a free side cell can be made by two side moves through it,
+    // so only cut corners connect cells that side moves do not.
+    // Labels are rebuilt when Maze::revision changes. Cells reported with `cells_changed` that stopped being walls
+    // are joined to regions around them right away, new walls may split a region and leave a rebuild for the next query.
+    class ConnectedComponents {
+    public:
+        ConnectedComponents(const Maze& maze, bool allow_diagonals, bool corners_require_adjacent = true);
+
+        bool allow_diagonals() const {
+            return m_allow_diagonals;
+        }
+
+        bool corners_require_adjacent() const {
+            return m_corners_require_adjacent;
+        }
+
+        // Reports cells edited since `revision_before_edit`, see the class comment.
+        // Ignored if the maze had other edits since the labels were last updated.
+        void cells_changed(const std::vector<Maze::Node>& cells, uint64_t revision_before_edit);
+
+        // Brings labels up to date now rather than on the next query.
+        // Until the maze changes, queries then only read this object and may run on several threads.
+        void update();
+
+        // label of the region of `node`, npos for walls and cells outside of the maze
+        size_t label(const Maze::Node& node);
+
+        // whether some path leads from `from` to `to`, false if either of them is a wall or outside of the maze
+        bool connected(const Maze::Node& from, const Maze::Node& to) {
+            const auto from_label = label(from);
+            return from_label != npos && from_label == label(to);
+        }
+
+        size_t region_count();
+
+    private:
+        const Maze& m_maze;
+        bool m_allow_diagonals;
+        bool m_corners_require_adjacent;
+        size_t m_width = 0;
+        size_t m_height = 0;
+        // maze revision the labels were built for, 0 if never built
+        uint64_t m_revision = 0;
+        // a wall was reported since the last rebuild
+        bool m_needs_rebuild = false;
+        // union-find parent of every cell, npos for walls. Roots are labels
+        std::vector<size_t> m_parents;
+        // union by rank keeps trees O(log n) deep, so queries find roots without writing
+        std::vector<uint8_t> m_ranks;
+        size_t m_region_count = 0;
+
+        size_t slot_of(const Maze::Node& node) const {
+            return node.y * m_width + node.x;
+        }
+
+        size_t root(size_t slot) const {
+            while (m_parents[slot] != slot) {
+                slot = m_parents[slot];
+            }
+            return slot;
+        }
+
+        void join(size_t first, size_t second);
+        // joins labelled `node` with labelled cells it can move to, only ones above and left of it with `preceding_only`
+        void join_around(const Maze::Node& node, bool preceding_only);
+        void rebuild();
+    };
+}
@@ -0,0 +1,363 @@
+#pragma once
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <maze/maze.hpp>
+#include <util/static_vector.hpp>
+#include <util/util.hpp>
+
+#include "search_algos_util.hpp"
+
+
+namespace algos {
+    // Sparse graph of a maze where corridors - chains of cells with exactly two neighboors - are
+    // collapsed into single edges between the remaining cells (junctions and dead ends).
+    // Edge weights are sums of `get_weight` along the corridor, so slow tiles keep their cost.
+    // Perfect mazes are mostly corridors, so searches on this graph expand a small fraction of the cells.
+    //
+    // The neighbourhood has to be symmetric and have at most 8 neighboors per cell, like every Maze neighbourhood.
+    // The graph is rebuilt when Maze::revision changes.
+    template<typename Neighboors, typename Weight>
+    requires NeighboorsGetter<Neighboors, Maze::Node> && WeightGetter<Weight, Maze::Node>
+    class CorridorGraph {
+    public:
+        using Node = Maze::Node;
+        // junctions keep all their neighboors, plus query endpoints lying on their corridors
+        using NeighboorList = util::StaticVector<Node, 10>;
+
+        CorridorGraph(const Maze& maze, Neighboors get_neighboors, Weight get_weight)
+            : m_maze(maze)
+            , m_get_neighboors(std::move(get_neighboors))
+            , m_get_weight(std::move(get_weight)) {}
+
+        size_t junction_count() {
+            update();
+            return m_junctions.size();
+        }
+
+        size_t corridor_count() {
+            update();
+            return m_corridors.size();
+        }
+
+        // heaviest edge of the graph, bucket queues need it
+        double max_edge_weight() {
+            update();
+            double result = 0.0;
+            for (const auto& corridor : m_corridors) {
+                result = std::max({result, corridor.forward_weight, corridor.backward_weight});
+            }
+            return result;
+        }
+
+        // Runs `search(from, to, get_neighboors, get_weight, indexer)` on the graph, where `search` is
+        // any of the search templates returning a path from `to` back to `from`. Cells `from` and `to`
+        // join the graph for this query if they lie inside corridors.
+        // Returned path goes through every cell, from `to` back to `from` as well.
+        template<typename Search>
+        NodePath<Node> find_path(const Node& from, const Node& to, const Search& search) {
+            update();
+            if (!m_maze.is_valid(from) || !m_maze.is_valid(to) || m_maze.is_wall(from) || m_maze.is_wall(to)) {
+                return {};
+            }
+            if (from == to) {
+                return { from };
+            }
+            m_query_nodes.clear();
+            m_query_edges.clear();
+            add_query_node(from);
+            add_query_node(to);
+            if (m_query_nodes.size() == 2) {
+                const auto [from_corridor, from_position] = corridor_position(from);
+                const auto [to_corridor, to_position] = corridor_position(to);
+                if (from_corridor == to_corridor) {
+                    add_query_edge(from, to, from_corridor, from_position, to_position);
+                    add_query_edge(to, from, from_corridor, to_position, from_position);
+                }
+            }
+
+            auto get_neighboors = [this](const Node& node) {
+                return neighboors(node);
+            };
+            auto get_weight = [this](const Node& node, const Node& neighboor) {
+                return best_edge(node, neighboor).weight;
+            };
+            const auto compressed = search(from, to, get_neighboors, get_weight, Indexer{this});
+            if (compressed.empty()) {
+                return {};
+            }
+
+            NodePath<Node> path = { compressed.front() };
+            for (size_t i = 1; i < compressed.size(); ++i) {
+                // search went from compressed[i] to compressed[i - 1], cells are added in the opposite direction
+                const auto edge = best_edge(compressed[i], compressed[i - 1]);
+                auto position = edge.target_position;
+                while (position != edge.source_position) {
+                    position = position < edge.source_position ? position + 1 : position - 1;
+                    path.push_back(corridor_cell(edge.corridor, position));
+                }
+            }
+            return path;
+        }
+
+    private:
+        // Cells of a corridor are stored in order from `first_end` to `last_end`. Positions along it
+        // count the ends too: `first_end` is at 0, cells at 1..size, `last_end` at size + 1.
+        struct Corridor {
+            Node first_end;
+            Node last_end;
+            size_t offset;
+            size_t size;
+            double forward_weight;
+            double backward_weight;
+        };
+
+        struct Edge {
+            Node target;
+            double weight;
+            size_t corridor;
+            size_t source_position;
+            size_t target_position;
+        };
+
+        struct SourcedEdge {
+            Node source;
+            Edge edge;
+        };
+
+        // junctions take their own indices, query nodes the ones after them
+        struct Indexer {
+            const CorridorGraph* graph;
+
+            size_t operator()(const Node& node) const {
+                const auto index = graph->m_junction_index[graph->cell_index(node)];
+                if (index != npos) {
+                    return index;
+                }
+                return graph->m_junctions.size() + size_t(rng::find(graph->m_query_nodes, node) - graph->m_query_nodes.begin());
+            }
+
+            size_t size() const {
+                return graph->m_junctions.size() + 2;
+            }
+        };
+
+        const Maze& m_maze;
+        Neighboors m_get_neighboors;
+        Weight m_get_weight;
+        // maze revision the graph was built for, 0 if never built
+        uint64_t m_revision = 0;
+        std::vector<Node> m_junctions;
+        // per cell, npos for cells that are not junctions
+        std::vector<size_t> m_junction_index;
+        // per cell, index in m_corridor_cells or npos
+        std::vector<size_t> m_corridor_cell_index;
+        std::vector<Node> m_corridor_cells;
+        std::vector<Corridor> m_corridors;
+        // edges leaving junction i are m_edges[m_edge_offsets[i]..m_edge_offsets[i + 1])
+        std::vector<size_t> m_edge_offsets;
+        std::vector<Edge> m_edges;
+        // endpoints of the current query lying inside corridors, and edges connecting them
+        util::StaticVector<Node, 2> m_query_nodes;
+        std::vector<SourcedEdge> m_query_edges;
+
+        size_t cell_index(const Node& node) const {
+            return util::coords_to_idx(node.x, node.y, m_maze.width);
+        }
+
+        bool is_junction(const Node& node) const {
+            return m_junction_index[cell_index(node)] != npos;
+        }
+
+        Node corridor_cell(size_t corridor, size_t position) const {
+            const auto& record = m_corridors[corridor];
+            if (position == 0) {
+                return record.first_end;
+            }
+            if (position == record.size + 1) {
+                return record.last_end;
+            }
+            return m_corridor_cells[record.offset + position - 1];
+        }
+
+        std::pair<size_t, size_t> corridor_position(const Node& node) const {
+            const auto index = m_corridor_cell_index[cell_index(node)];
+            const auto corridor = size_t(rng::upper_bound(m_corridors, index, {}, &Corridor::offset) - m_corridors.begin()) - 1;
+            return { corridor, index - m_corridors[corridor].offset + 1 };
+        }
+
+        double segment_weight(size_t corridor, size_t from_position, size_t to_position) const {
+            double weight = 0.0;
+            for (auto position = from_position; position != to_position;) {
+                const auto next = position < to_position ? position + 1 : position - 1;
+                weight += double(m_get_weight(corridor_cell(corridor, position), corridor_cell(corridor, next)));
+                position = next;
+            }
+            return weight;
+        }
+
+        void add_query_edge(const Node& source, const Node& target, size_t corridor, size_t source_position, size_t target_position) {
+            const auto weight = segment_weight(corridor, source_position, target_position);
+            m_query_edges.push_back({source, {target, weight, corridor, source_position, target_position}});
+        }
+
+        void add_query_node(const Node& node) {
+            if (is_junction(node)) {
+                return;
+            }
+            m_query_nodes.push_back(node);
+            const auto [corridor, position] = corridor_position(node);
+            const auto last_position = m_corridors[corridor].size + 1;
+            add_query_edge(node, m_corridors[corridor].first_end, corridor, position, 0);
+            add_query_edge(node, m_corridors[corridor].last_end, corridor, position, last_position);
+            add_query_edge(m_corridors[corridor].first_end, node, corridor, 0, position);
+            add_query_edge(m_corridors[corridor].last_end, node, corridor, last_position, position);
+        }
+
+        NeighboorList neighboors(const Node& node) const {
+            NeighboorList result;
+            auto add = [&](const Node& target) {
+                if (rng::find(result, target) == result.end()) {
+                    result.push_back(target);
+                }
+            };
+            const auto junction = m_junction_index[cell_index(node)];
+            if (junction != npos) {
+                for (size_t i = m_edge_offsets[junction]; i < m_edge_offsets[junction + 1]; ++i) {
+                    add(m_edges[i].target);
+                }
+            }
+            for (const auto& [source, edge] : m_query_edges) {
+                if (source == node) {
+                    add(edge.target);
+                }
+            }
+            return result;
+        }
+
+        // parallel corridors may connect the same cells, the lightest one is used
+        Edge best_edge(const Node& node, const Node& neighboor) const {
+            const Edge* best = nullptr;
+            auto consider = [&](const Edge& edge) {
+                if (edge.target == neighboor && (best == nullptr || edge.weight < best->weight)) {
+                    best = &edge;
+                }
+            };
+            const auto junction = m_junction_index[cell_index(node)];
+            if (junction != npos) {
+                for (size_t i = m_edge_offsets[junction]; i < m_edge_offsets[junction + 1]; ++i) {
+                    consider(m_edges[i]);
+                }
+            }
+            for (const auto& [source, edge] : m_query_edges) {
+                if (source == node) {
+                    consider(edge);
+                }
+            }
+            if (best == nullptr) {
+                throw std::logic_error("Nodes are not connected in the corridor graph!");
+            }
+            return *best;
+        }
+
+        // walks a corridor starting with the move from `junction` to `first`, records it once for both directions
+        void walk_corridor(const Node& junction, const Node& first, std::vector<SourcedEdge>& edges) {
+            std::vector<Node> cells;
+            double forward_weight = double(m_get_weight(junction, first));
+            double backward_weight = double(m_get_weight(first, junction));
+            auto previous = junction;
+            auto current = first;
+            while (!is_junction(current)) {
+                const auto around = m_get_neighboors(current);
+                const Node next = around[0] == previous ? around[1] : around[0];
+                cells.push_back(current);
+                forward_weight += double(m_get_weight(current, next));
+                backward_weight += double(m_get_weight(next, current));
+                previous = current;
+                current = next;
+            }
+
+            // corridor is found from both of its ends, or twice from the same one if it is a loop
+            const auto first_index = m_junction_index[cell_index(junction)];
+            const auto last_index = m_junction_index[cell_index(current)];
+            const bool is_loop = first_index == last_index;
+            if (first_index > last_index || (is_loop && cell_index(cells.front()) > cell_index(cells.back()))) {
+                return;
+            }
+            const auto corridor = m_corridors.size();
+            for (const auto& cell : cells) {
+                m_corridor_cell_index[cell_index(cell)] = m_corridor_cells.size();
+                m_corridor_cells.push_back(cell);
+            }
+            m_corridors.push_back({junction, current, m_corridor_cells.size() - cells.size(), cells.size(), forward_weight, backward_weight});
+            if (!is_loop) {
+                edges.push_back({junction, {current, forward_weight, corridor, 0, cells.size() + 1}});
+                edges.push_back({current, {junction, backward_weight, corridor, cells.size() + 1, 0}});
+            }
+        }
+
+        void add_junction(const Node& node) {
+            m_junction_index[cell_index(node)] = m_junctions.size();
+            m_junctions.push_back(node);
+        }
+
+        void update() {
+            if (m_revision == m_maze.revision) {
+                return;
+            }
+            m_revision = m_maze.revision;
+            const auto cell_count = m_maze.cell_count();
+            m_junctions.clear();
+            m_junction_index.assign(cell_count, npos);
+            m_corridor_cell_index.assign(cell_count, npos);
+            m_corridor_cells.clear();
+            m_corridors.clear();
+
+            for (size_t y = 0; y < m_maze.height; ++y) {
+                for (size_t x = 0; x < m_maze.width; ++x) {
+                    const Node node{x, y};
+                    if (!m_maze.is_wall(node) && m_get_neighboors(node).size() != 2) {
+                        add_junction(node);
+                    }
+                }
+            }
+            std::vector<SourcedEdge> edges;
+            for (size_t junction = 0; junction < m_junctions.size(); ++junction) {
+                const auto node = m_junctions[junction];
+                for (const auto& neighboor : m_get_neighboors(node)) {
+                    walk_corridor(node, neighboor, edges);
+                }
+            }
+            // closed rings of corridor cells get one of their cells as a junction
+            for (size_t y = 0; y < m_maze.height; ++y) {
+                for (size_t x = 0; x < m_maze.width; ++x) {
+                    const Node node{x, y};
+                    if (m_maze.is_wall(node) || is_junction(node) || m_corridor_cell_index[cell_index(node)] != npos) {
+                        continue;
+                    }
+                    add_junction(node);
+                    for (const auto& neighboor : m_get_neighboors(node)) {
+                        walk_corridor(node, neighboor, edges);
+                    }
+                }
+            }
+
+            rng::stable_sort(edges, {}, [&](const SourcedEdge& edge) {
+                return m_junction_index[cell_index(edge.source)];
+            });
+            m_edge_offsets.assign(m_junctions.size() + 1, 0);
+            m_edges.clear();
+            m_edges.reserve(edges.size());
+            for (const auto& [source, edge] : edges) {
+                ++m_edge_offsets[m_junction_index[cell_index(source)] + 1];
+                m_edges.push_back(edge);
+            }
+            for (size_t i = 1; i < m_edge_offsets.size(); ++i) {
+                m_edge_offsets[i] += m_edge_offsets[i - 1];
+            }
+        }
+    };
+}
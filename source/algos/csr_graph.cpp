@@ -0,0 +1,142 @@
+#include "csr_graph.hpp"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <fstream>
+#include <string>
+
+#include <util/util.hpp>
+
+
+namespace algos {
+    namespace {
+        std::runtime_error edge_list_error(const std::filesystem::path& path, size_t line, const char* what) {
+            return std::runtime_error("\"" + path.string() + "\", line " + std::to_string(line) + ": " + what);
+        }
+
+        // skips spaces and tabs, returns false if nothing else is left
+        bool skip_blanks(const char*& begin, const char* end) {
+            while (begin != end && (*begin == ' ' || *begin == '\t' || *begin == '\r')) {
+                ++begin;
+            }
+            return begin != end;
+        }
+    }
+
+    CsrGraph::CsrGraph(size_t node_count, std::span<const Edge> edges) {
+        // offsets keep one more entry than there are nodes
+        if (node_count > max_node_count || node_count == std::numeric_limits<size_t>::max()) {
+            throw std::logic_error("CsrGraph: too many nodes");
+        }
+        // counting sort by the node edges leave, which keeps their order within a node
+        m_offsets.assign(node_count + 1, 0);
+        for (const auto& edge : edges) {
+            if (edge.from >= node_count || edge.to >= node_count) {
+                throw std::logic_error("CsrGraph: edge to a node outside of the graph");
+            }
+            ++m_offsets[size_t(edge.from) + 1];
+        }
+        for (size_t node = 0; node < node_count; ++node) {
+            m_offsets[node + 1] += m_offsets[node];
+        }
+        m_targets.resize(edges.size());
+        m_weights.resize(edges.size());
+        auto next = m_offsets;
+        for (const auto& edge : edges) {
+            const auto position = next[edge.from]++;
+            m_targets[position] = edge.to;
+            m_weights[position] = edge.weight;
+        }
+
+        // an edge list may repeat an edge with other costs, searches relax only the cheapest one
+        // and weight() has to give that cost back. Edges are moved down over the merged ones
+        std::vector<size_t> kept_at(node_count, std::numeric_limits<size_t>::max());
+        size_t kept = 0;
+        for (size_t node = 0; node < node_count; ++node) {
+            const auto begin = m_offsets[node];
+            const auto end = m_offsets[node + 1];
+            m_offsets[node] = kept;
+            for (auto edge = begin; edge < end; ++edge) {
+                auto& slot = kept_at[m_targets[edge]];
+                // slots of earlier nodes are all below the first slot of this one
+                if (slot != std::numeric_limits<size_t>::max() && slot >= m_offsets[node]) {
+                    m_weights[slot] = std::min(m_weights[slot], m_weights[edge]);
+                    continue;
+                }
+                slot = kept;
+                m_targets[kept] = m_targets[edge];
+                m_weights[kept] = m_weights[edge];
+                ++kept;
+            }
+        }
+        m_offsets[node_count] = kept;
+        m_targets.resize(kept);
+        m_weights.resize(kept);
+    }
+
+    CsrGraph CsrGraph::load_edge_list(const std::filesystem::path& path) {
+        std::ifstream file(path, std::ios::in | std::ios::binary);
+        if (!file) {
+            throw std::runtime_error("\"" + path.string() + "\": can not open file");
+        }
+        size_t size = 0;
+        if (!util::to_size(std::filesystem::file_size(path), size)) {
+            throw std::runtime_error("\"" + path.string() + "\": file is too big");
+        }
+        std::string text(size, '\0');
+        file.read(text.data(), std::streamsize(text.size()));
+        if (!file) {
+            throw std::runtime_error("\"" + path.string() + "\": can not read file");
+        }
+
+        std::vector<Edge> edges;
+        uint64_t node_count = 0;
+        size_t line_number = 0;
+        for (size_t line_start = 0; line_start < text.size();) {
+            ++line_number;
+            const auto line_end = std::min(text.find('\n', line_start), text.size());
+            const char* begin = text.data() + line_start;
+            const char* end = text.data() + line_end;
+            line_start = line_end + 1;
+            if (!skip_blanks(begin, end) || *begin == '#') {
+                continue;
+            }
+
+            std::array<uint64_t, 2> nodes;
+            for (auto& node : nodes) {
+                if (!skip_blanks(begin, end)) {
+                    throw edge_list_error(path, line_number, "an edge needs two nodes");
+                }
+                const auto [ptr, error] = std::from_chars(begin, end, node);
+                if (error != std::errc() || node >= max_node_count) {
+                    throw edge_list_error(path, line_number, "bad node number");
+                }
+                begin = ptr;
+            }
+            double weight = 1.0;
+            if (skip_blanks(begin, end)) {
+                const auto [ptr, error] = std::from_chars(begin, end, weight);
+                if (error != std::errc()) {
+                    throw edge_list_error(path, line_number, "bad edge weight");
+                }
+                // searches over the graph need costs they can add up and compare
+                if (!std::isfinite(weight) || weight < 0.0) {
+                    throw edge_list_error(path, line_number, "edge weight has to be finite and not negative");
+                }
+                begin = ptr;
+            }
+            if (skip_blanks(begin, end)) {
+                throw edge_list_error(path, line_number, "unexpected text after the edge");
+            }
+            edges.push_back({Node(nodes[0]), Node(nodes[1]), weight});
+            node_count = std::max(node_count, std::max(nodes[0], nodes[1]) + 1);
+        }
+        size_t graph_nodes = 0;
+        if (!util::to_size(node_count, graph_nodes)) {
+            throw std::runtime_error("\"" + path.string() + "\": too many nodes");
+        }
+        return CsrGraph(graph_nodes, edges);
+    }
+}
@@ -0,0 +1,184 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include <maze/maze.hpp>
+#include <util/thread_pool.hpp>
+
+#include "search_algos_util.hpp"
+
+
+namespace algos {
+    // Directed graph frozen into compressed sparse rows: edges leaving node `n` are
+    // targets[offsets[n]] .. targets[offsets[n + 1] - 1], with their costs at the same positions of `weights`.
+    // Neighboors of a node are one contiguous slice, so searches read memory in order
+    // instead of asking a maze about every cell around the node they expand.
+    //
+    // Nodes are numbers in [0, node_count()). A graph built from a Maze numbers cells like Maze::NodeIndexer,
+    // walls are nodes without edges. It is a snapshot, later edits of the maze are not seen.
+    class CsrGraph {
+    public:
+        using Node = uint32_t;
+
+        struct Edge {
+            Node from;
+            Node to;
+            double weight;
+        };
+
+        // Node numbers are their own slots, usable as algos::NodeIndexer
+        struct NodeIndexer {
+            size_t count;
+
+            size_t operator()(Node node) const {
+                return node;
+            }
+
+            size_t size() const {
+                return count;
+            }
+
+            Node node(size_t slot) const {
+                return Node(slot);
+            }
+        };
+
+        // 64 bit, so it does not wrap to 0 where size_t is 32 bit
+        static constexpr uint64_t max_node_count = uint64_t(std::numeric_limits<Node>::max()) + 1;
+
+        CsrGraph() = default;
+        // Edges in any order, those leaving one node keep their order. Every node number has to be below `node_count`.
+        // Parallel edges are merged into one with the least of their weights, in the place of the first of them
+        CsrGraph(size_t node_count, std::span<const Edge> edges);
+
+        // Moves of `Policy` between maze cells with costs of `get_weight`, which gets two Maze::Node.
+        // Rows of cells are split between workers of `pool`, each asks the maze about its own cells only once.
+        template<typename Policy, typename Weight>
+        static CsrGraph from_maze(const Maze& maze, Policy, const Weight& get_weight, util::ThreadPool& pool);
+
+        // Text file with one edge per line: "<from> <to>" or "<from> <to> <weight>", weight is 1 if left out and can not be negative.
+        // Empty lines and lines starting with '#' are skipped. There are as many nodes as the greatest number used, plus one
+        static CsrGraph load_edge_list(const std::filesystem::path&);
+
+        size_t node_count() const {
+            return m_offsets.size() - 1;
+        }
+
+        size_t edge_count() const {
+            return m_targets.size();
+        }
+
+        std::span<const Node> neighboors(Node node) const {
+            return {m_targets.data() + m_offsets[node], m_targets.data() + m_offsets[size_t(node) + 1]};
+        }
+
+        // costs of edges in the order of `neighboors`
+        std::span<const double> weights(Node node) const {
+            return {m_weights.data() + m_offsets[node], m_weights.data() + m_offsets[size_t(node) + 1]};
+        }
+
+        // cost of the edge from `from` to `to`, infinity if there is none
+        double weight(Node from, Node to) const {
+            for (auto edge = m_offsets[from]; edge < m_offsets[size_t(from) + 1]; ++edge) {
+                if (m_targets[edge] == to) {
+                    return m_weights[edge];
+                }
+            }
+            return std::numeric_limits<double>::infinity();
+        }
+
+        NodeIndexer get_node_indexer() const {
+            return {node_count()};
+        }
+
+    private:
+        std::vector<size_t> m_offsets = { 0 };
+        std::vector<Node> m_targets;
+        std::vector<double> m_weights;
+    };
+
+    // Graph bound to a getter, usable as algos::NeighboorsGetter. Gives a view of the graph, nothing is copied
+    struct CsrNeighboors {
+        const CsrGraph* graph;
+
+        std::span<const CsrGraph::Node> operator()(CsrGraph::Node node) const {
+            return graph->neighboors(node);
+        }
+    };
+
+    // Same for algos::WeightGetter, finds the edge among neighboors of `from`
+    struct CsrWeight {
+        const CsrGraph* graph;
+
+        double operator()(CsrGraph::Node from, CsrGraph::Node to) const {
+            return graph->weight(from, to);
+        }
+    };
+
+    template<typename Policy, typename Weight>
+    CsrGraph CsrGraph::from_maze(const Maze& maze, Policy, const Weight& get_weight, util::ThreadPool& pool) {
+        if (maze.cell_count() > max_node_count) {
+            throw std::logic_error("CsrGraph: maze has more cells than node numbers");
+        }
+        // edges of a few whole rows, so workers do not share anything they write
+        struct Rows {
+            // a cell has at most 8 neighboors
+            std::vector<uint8_t> degrees;
+            std::vector<Node> targets;
+            std::vector<double> weights;
+        };
+        constexpr size_t rows_per_chunk = 16;
+        const auto indexer = maze.get_node_indexer();
+        std::vector<Rows> chunks((maze.height + rows_per_chunk - 1) / rows_per_chunk);
+        pool.for_each_chunk(maze.height, rows_per_chunk, [&](size_t, size_t begin, size_t end) {
+            auto& [degrees, targets, weights] = chunks[begin / rows_per_chunk];
+            degrees.reserve((end - begin) * maze.width);
+            for (size_t y = begin; y < end; ++y) {
+                for (size_t x = 0; x < maze.width; ++x) {
+                    const Maze::Node node{x, y};
+                    if (maze.is_wall(node)) {
+                        degrees.push_back(0);
+                        continue;
+                    }
+                    const auto neighboors = Policy::get(maze, node);
+                    degrees.push_back(uint8_t(neighboors.size()));
+                    for (const auto& neighboor : neighboors) {
+                        targets.push_back(Node(indexer(neighboor)));
+                        weights.push_back(double(get_weight(node, neighboor)));
+                    }
+                }
+            }
+        });
+
+        CsrGraph graph;
+        graph.m_offsets.resize(maze.cell_count() + 1);
+        // where edges of every chunk start, then the chunks are copied into place in parallel
+        std::vector<size_t> chunk_starts = { 0 };
+        for (const auto& chunk : chunks) {
+            chunk_starts.push_back(chunk_starts.back() + chunk.targets.size());
+        }
+        graph.m_targets.resize(chunk_starts.back());
+        graph.m_weights.resize(chunk_starts.back());
+        pool.for_each_chunk(chunks.size(), 1, [&](size_t, size_t begin, size_t end) {
+            for (auto i = begin; i < end; ++i) {
+                const auto& chunk = chunks[i];
+                const auto first_slot = i * rows_per_chunk * maze.width;
+                auto offset = chunk_starts[i];
+                for (size_t cell = 0; cell < chunk.degrees.size(); ++cell) {
+                    graph.m_offsets[first_slot + cell] = offset;
+                    offset += chunk.degrees[cell];
+                }
+                rng::copy(chunk.targets, graph.m_targets.begin() + ptrdiff_t(chunk_starts[i]));
+                rng::copy(chunk.weights, graph.m_weights.begin() + ptrdiff_t(chunk_starts[i]));
+            }
+        });
+        graph.m_offsets.back() = chunk_starts.back();
+        return graph;
+    }
+}
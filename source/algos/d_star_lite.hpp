@@ -0,0 +1,239 @@
+#pragma once
+
+#include <algorithm>
+#include <concepts>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include <maze/maze.hpp>
+
+#include "search_algos_util.hpp"
+#include "search_observer.hpp"
+#include "indexed_heap.hpp"
+
+
+namespace algos {
+    // D* Lite (Koenig, Likhachev): A* searching backwards from the goal, whose distance estimates
+    // are kept between queries. After an edit only cells whose estimates it invalidates are
+    // expanded again, and the start may move between queries without restarting the search.
+    //
+    // `heuristic(a, b)` has to be a consistent lower bound of the cost between two cells.
+    // The neighbourhood has to be symmetric and made of adjacent cells, like every Maze neighbourhood.
+    // Edits made through Maze are noticed on the next query and restart the search, reporting
+    // edited cells with `cells_changed` lets it repair only what they affect. A new goal restarts it too.
+    template<typename Neighboors, typename Weight, typename Heuristic>
+    requires NeighboorsGetter<Neighboors, Maze::Node>
+        && WeightGetter<Weight, Maze::Node>
+        && std::invocable<const Heuristic&, const Maze::Node&, const Maze::Node&>
+    class DStarLite {
+    public:
+        using Node = Maze::Node;
+
+        DStarLite(const Maze& maze, Neighboors get_neighboors, Weight get_weight, Heuristic heuristic)
+            : m_maze(maze)
+            , m_get_neighboors(std::move(get_neighboors))
+            , m_get_weight(std::move(get_weight))
+            , m_heuristic(std::move(heuristic)) {}
+
+        // Reports cells edited since `revision_before_edit`, so the next query repairs only what depends on them.
+        // Ignored if the maze had other edits since the last query.
+        void cells_changed(const std::vector<Node>& cells, uint64_t revision_before_edit) {
+            if (m_revision == revision_before_edit && m_maze.width == m_width && m_maze.height == m_height) {
+                m_changed.insert(m_changed.end(), cells.begin(), cells.end());
+                m_revision = m_maze.revision;
+            }
+        }
+
+        // Path from `to` back to `from`, like reconstruct_path.
+        // `on_expand` is called for every cell taken from the open list, only repairs are expanded after edits.
+        // `observer` sees the backward search: relaxations are found from a neighboor closer to the goal.
+        template<typename OnExpand = EmptyUpdate<Node>, typename Observer = NullSearchObserver>
+        requires SearchObserver<Observer, Node>
+        NodePath<Node> find_path(const Node& from, const Node& to, const OnExpand& on_expand = {}, const Observer& observer = {}) {
+            if (!m_maze.is_valid(from) || !m_maze.is_valid(to) || m_maze.is_wall(from) || m_maze.is_wall(to)) {
+                return {};
+            }
+            if (m_revision != m_maze.revision || m_width != m_maze.width || m_height != m_maze.height || m_goal != slot_of(to)) {
+                restart(from, to, observer);
+            } else {
+                // keys already queued are lower by this much than ones computed from the new start,
+                // the difference is added to new keys instead of updating the queue
+                m_key_offset += heuristic(m_last_start, from);
+                m_last_start = from;
+                for (const auto& cell : m_changed) {
+                    for_each_cell_around(cell, [&](const Node& node) {
+                        update_cell(node, from, observer);
+                    });
+                }
+            }
+            m_changed.clear();
+            compute_distances(from, on_expand, observer);
+
+            if (m_distances[slot_of(from)] == infinity) {
+                return {};
+            }
+            // every step goes to the neighboor with the least cost through it
+            NodePath<Node> path = { from };
+            while (path.back() != to) {
+                if (path.size() > m_distances.size()) {
+                    return {};
+                }
+                const auto& node = path.back();
+                std::optional<Node> best;
+                double best_distance = infinity;
+                for (const Node& neighboor : m_get_neighboors(node)) {
+                    const auto distance = double(m_get_weight(node, neighboor)) + m_distances[slot_of(neighboor)];
+                    if (distance < best_distance) {
+                        best_distance = distance;
+                        best = neighboor;
+                    }
+                }
+                if (!best) {
+                    return {};
+                }
+                path.push_back(*best);
+            }
+            rng::reverse(path);
+            return path;
+        }
+
+    private:
+        static constexpr double infinity = std::numeric_limits<double>::infinity();
+        static constexpr double heuristic_scale = 1.0 - 1e-9;
+        using Key = std::pair<double, double>;
+
+        const Maze& m_maze;
+        Neighboors m_get_neighboors;
+        Weight m_get_weight;
+        Heuristic m_heuristic;
+        size_t m_width = 0;
+        size_t m_height = 0;
+        size_t m_goal = npos;
+        // maze revision the search state belongs to, 0 if there is none
+        uint64_t m_revision = 0;
+        Node m_last_start;
+        double m_key_offset = 0.0;
+        // settled cost from a cell to the goal
+        std::vector<double> m_distances;
+        // one step lookahead of m_distances, cells where they differ are queued
+        std::vector<double> m_lookahead;
+        IndexedHeap<Key> m_open;
+        // reported since the last query
+        std::vector<Node> m_changed;
+
+        size_t slot_of(const Node& node) const {
+            return node.y * m_width + node.x;
+        }
+
+        double heuristic(const Node& from, const Node& to) const {
+            return double(m_heuristic(from, to));
+        }
+
+        Key key(const Node& node, const Node& start) const {
+            const auto slot = slot_of(node);
+            const auto distance = std::min(m_distances[slot], m_lookahead[slot]);
+            // Heuristics that are exact along straight lines (euclidean distance with diagonal moves)
+            // can come out inconsistent by a rounding error, which breaks the stopping condition.
+            // Scaling them down by a hair leaves enough slack for it.
+            return { distance + heuristic(start, node) * heuristic_scale + m_key_offset, distance };
+        }
+
+        // the cell itself and cells around it, inside the maze
+        template<typename Callback>
+        void for_each_cell_around(const Node& node, const Callback& callback) const {
+            for (size_t y = node.y == 0 ? 0 : node.y - 1; y <= std::min(node.y + 1, m_height - 1); ++y) {
+                for (size_t x = node.x == 0 ? 0 : node.x - 1; x <= std::min(node.x + 1, m_width - 1); ++x) {
+                    callback(Node{x, y});
+                }
+            }
+        }
+
+        template<typename Observer>
+        void restart(const Node& from, const Node& to, const Observer& observer) {
+            m_width = m_maze.width;
+            m_height = m_maze.height;
+            m_revision = m_maze.revision;
+            m_goal = slot_of(to);
+            m_last_start = from;
+            m_key_offset = 0.0;
+            m_distances.assign(m_maze.cell_count(), infinity);
+            m_lookahead.assign(m_maze.cell_count(), infinity);
+            m_open.clear();
+            m_lookahead[m_goal] = 0.0;
+            m_open.push(m_goal, key(to, from));
+            observer.discovered(to);
+            observer.pushed(to, m_open.size());
+        }
+
+        // recomputes the lookahead of a cell and queues it if it is inconsistent
+        template<typename Observer>
+        void update_cell(const Node& node, const Node& start, const Observer& observer) {
+            const auto slot = slot_of(node);
+            const auto previous_lookahead = m_lookahead[slot];
+            // neighboor the lookahead goes through
+            std::optional<Node> through;
+            if (slot != m_goal) {
+                double lookahead = infinity;
+                if (!m_maze.is_wall(node)) {
+                    for (const Node& neighboor : m_get_neighboors(node)) {
+                        const auto distance = double(m_get_weight(node, neighboor)) + m_distances[slot_of(neighboor)];
+                        if (distance < lookahead) {
+                            lookahead = distance;
+                            through = neighboor;
+                        }
+                    }
+                }
+                m_lookahead[slot] = lookahead;
+            }
+            const bool inconsistent = m_distances[slot] != m_lookahead[slot];
+            if (m_open.contains(slot)) {
+                if (inconsistent) {
+                    m_open.update(slot, key(node, start));
+                    if (through && m_lookahead[slot] < previous_lookahead) {
+                        observer.relaxed(*through, node);
+                    }
+                } else {
+                    m_open.erase(slot);
+                    observer.popped(node, m_open.size());
+                }
+            } else if (inconsistent) {
+                if (previous_lookahead == infinity && m_distances[slot] == infinity) {
+                    observer.discovered(node);
+                }
+                m_open.push(slot, key(node, start));
+                observer.pushed(node, m_open.size());
+            }
+        }
+
+        template<typename OnExpand, typename Observer>
+        void compute_distances(const Node& start, const OnExpand& on_expand, const Observer& observer) {
+            const auto start_slot = slot_of(start);
+            while (!m_open.empty()
+                   && (m_open.top_priority() < key(start, start) || m_lookahead[start_slot] != m_distances[start_slot])) {
+                const auto slot = m_open.top();
+                const Node node{slot % m_width, slot / m_width};
+                const auto current_key = key(node, start);
+                if (m_open.top_priority() < current_key) {
+                    m_open.update(slot, current_key);
+                    continue;
+                }
+                m_open.pop();
+                observer.popped(node, m_open.size());
+                observer.expanded(node);
+                on_expand(node);
+                if (m_distances[slot] > m_lookahead[slot]) {
+                    m_distances[slot] = m_lookahead[slot];
+                } else {
+                    m_distances[slot] = infinity;
+                    update_cell(node, start, observer);
+                }
+                for (const Node& neighboor : m_get_neighboors(node)) {
+                    update_cell(neighboor, start, observer);
+                }
+            }
+        }
+    };
+}
@@ -0,0 +1,264 @@
+#pragma once
+
+#include <algorithm>
+#include <concepts>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include <util/thread_pool.hpp>
+
+#include "search_algos_util.hpp"
+#include "search_observer.hpp"
+
+
+namespace algos {
+    // Distances from one source to every slot of an indexer, with the tree of shortest paths.
+    template<typename Node, typename Indexer>
+    struct ShortestPathTree {
+        Indexer indexer;
+        size_t source;
+        // infinity for slots that were not reached
+        std::vector<double> distances;
+        // parent slot on a shortest path, npos for slots that were not reached, the source is its own parent
+        std::vector<size_t> parents;
+
+        bool is_reached(const Node& node) const {
+            return parents[indexer(node)] != npos;
+        }
+
+        double distance(const Node& node) const {
+            return distances[indexer(node)];
+        }
+
+        // path from `to` back to the source, like reconstruct_path. Empty if `to` was not reached
+        NodePath<Node> path_to(const Node& to) const {
+            if (!is_reached(to)) {
+                return {};
+            }
+            NodePath<Node> path;
+            for (auto slot = indexer(to); ; slot = parents[slot]) {
+                path.push_back(indexer.node(slot));
+                if (slot == source) {
+                    return path;
+                }
+            }
+        }
+
+        // reached nodes not further than `max_distance`, in the order Dijkstra would settle them
+        std::vector<Node> nodes_by_distance(double max_distance = std::numeric_limits<double>::infinity()) const {
+            std::vector<size_t> slots;
+            for (size_t slot = 0; slot < distances.size(); ++slot) {
+                if (parents[slot] != npos && distances[slot] <= max_distance) {
+                    slots.push_back(slot);
+                }
+            }
+            rng::stable_sort(slots, {}, [&](size_t slot) {
+                return distances[slot];
+            });
+            std::vector<Node> nodes;
+            nodes.reserve(slots.size());
+            rng::transform(slots, std::back_inserter(nodes), [&](size_t slot) {
+                return indexer.node(slot);
+            });
+            return nodes;
+        }
+    };
+
+    // Delta-stepping single source shortest paths (Meyer, Sanders) on a thread pool.
+    // Nodes are kept in buckets of `bucket_width` wide distance ranges. The lowest bucket is settled by
+    // relaxing its light edges (not heavier than `bucket_width`) until no node falls back into it, then
+    // heavy edges of everything removed from it are relaxed once. Every slot is owned by one worker,
+    // which alone applies relaxation requests targeting it, so no atomics are needed.
+    // A width near the typical edge weight does well: tiny widths serialize into Dijkstra, huge ones into Bellman-Ford.
+    //
+    // Weights must not be negative. `get_neighboors` and `get_weight` are called from several threads at once.
+    // `observer` is only called from the calling thread, events of workers are handed to it after every phase.
+    // Nodes are expanded bucket by bucket, the open list is every slot waiting in any bucket.
+    template<
+        std::equality_comparable Node,
+        typename Neighboors,
+        typename Weight,
+        typename Indexer,
+        typename Observer = NullSearchObserver
+    >
+    requires NeighboorsGetter<Neighboors, Node>
+        && WeightGetter<Weight, Node>
+        && ReversibleNodeIndexer<Indexer, Node>
+        && SearchObserver<Observer, Node>
+    static ShortestPathTree<Node, Indexer> DeltaSteppingShortestPaths(
+            const Node& from,
+            const Neighboors& get_neighboors,
+            const Weight& get_weight,
+            const Indexer& indexer,
+            double bucket_width,
+            util::ThreadPool& pool,
+            const Observer& observer = {}
+    ) {
+        if (!(bucket_width > 0.0)) {
+            throw std::logic_error("DeltaSteppingShortestPaths: bucket width has to be positive");
+        }
+        struct Request {
+            size_t target;
+            size_t parent;
+            double distance;
+        };
+        // request that lowered a distance, kept for the observer
+        struct Applied {
+            size_t target;
+            size_t parent;
+            bool is_first; // target was not reached before
+            bool is_queued; // target was not waiting in any bucket before
+        };
+        // without an observer nothing is recorded
+        constexpr bool is_observed = !std::same_as<Observer, NullSearchObserver>;
+
+        const size_t size = indexer.size();
+        const size_t workers = pool.size();
+        ShortestPathTree<Node, Indexer> tree{indexer, indexer(from), {}, {}};
+        tree.distances.assign(size, std::numeric_limits<double>::infinity());
+        tree.parents.assign(size, npos);
+        // bucket a slot is queued in, npos if none. Entries left in other buckets are stale
+        std::vector<size_t> queued_in(size, npos);
+        // buckets[worker][bucket] holds slots owned by the worker
+        std::vector<std::vector<std::vector<size_t>>> buckets(workers);
+        // removed from the current bucket, their heavy edges are relaxed when it is settled
+        std::vector<std::vector<size_t>> settled(workers);
+        std::vector<std::vector<size_t>> frontiers(workers);
+        // requests[from worker * workers + owner]
+        std::vector<std::vector<Request>> requests(workers * workers);
+        std::vector<std::vector<Applied>> applied(is_observed ? workers : 0);
+        // slots waiting in any bucket
+        size_t open_size = 0;
+
+        auto owner = [workers](size_t slot) {
+            return slot % workers;
+        };
+        auto bucket_of = [bucket_width](double distance) {
+            return size_t(distance / bucket_width);
+        };
+        auto enqueue = [&](size_t worker, size_t slot) {
+            const auto bucket = bucket_of(tree.distances[slot]);
+            if (queued_in[slot] == bucket) {
+                return;
+            }
+            queued_in[slot] = bucket;
+            if (buckets[worker].size() <= bucket) {
+                buckets[worker].resize(bucket + 1);
+            }
+            buckets[worker][bucket].push_back(slot);
+        };
+
+        // every worker collects requests over its own nodes, then applies the ones targeting its slots
+        auto relax = [&](const std::vector<std::vector<size_t>>& sources, bool light) {
+            pool.run([&](size_t worker) {
+                for (size_t other = 0; other < workers; ++other) {
+                    requests[worker * workers + other].clear();
+                }
+                for (const auto slot : sources[worker]) {
+                    const Node node = indexer.node(slot);
+                    const auto distance = tree.distances[slot];
+                    for (const Node& neighboor : get_neighboors(node)) {
+                        const auto weight = double(get_weight(node, neighboor));
+                        if ((weight <= bucket_width) != light) {
+                            continue;
+                        }
+                        const size_t target = indexer(neighboor);
+                        // distances only change while requests are applied, reading them here is safe
+                        if (distance + weight < tree.distances[target]) {
+                            requests[worker * workers + owner(target)].push_back({target, slot, distance + weight});
+                        }
+                    }
+                }
+            });
+            pool.run([&](size_t worker) {
+                if constexpr (is_observed) {
+                    applied[worker].clear();
+                }
+                for (size_t other = 0; other < workers; ++other) {
+                    for (const auto& [target, parent, distance] : requests[other * workers + worker]) {
+                        if (distance < tree.distances[target]) {
+                            if constexpr (is_observed) {
+                                applied[worker].push_back({target, parent, tree.parents[target] == npos, queued_in[target] == npos});
+                            }
+                            tree.distances[target] = distance;
+                            tree.parents[target] = parent;
+                            enqueue(worker, target);
+                        }
+                    }
+                }
+            });
+            if constexpr (is_observed) {
+                for (const auto& own : applied) {
+                    for (const auto& [target, parent, is_first, is_queued] : own) {
+                        const Node node = indexer.node(target);
+                        if (is_first) {
+                            observer.discovered(node);
+                        } else {
+                            observer.relaxed(indexer.node(parent), node);
+                        }
+                        if (is_queued) {
+                            observer.pushed(node, ++open_size);
+                        }
+                    }
+                }
+            }
+        };
+
+        tree.distances[tree.source] = 0.0;
+        tree.parents[tree.source] = tree.source;
+        enqueue(owner(tree.source), tree.source);
+        observer.discovered(from);
+        observer.pushed(from, ++open_size);
+
+        for (size_t current = 0; ; ++current) {
+            // next bucket with anything queued
+            size_t next = npos;
+            for (const auto& own : buckets) {
+                for (auto bucket = current; bucket < std::min(own.size(), next); ++bucket) {
+                    if (!own[bucket].empty()) {
+                        next = bucket;
+                        break;
+                    }
+                }
+            }
+            if (next == npos) {
+                break;
+            }
+            current = next;
+
+            for (auto& own : settled) {
+                own.clear();
+            }
+            while (true) {
+                bool any = false;
+                for (size_t worker = 0; worker < workers; ++worker) {
+                    auto& frontier = frontiers[worker];
+                    frontier.clear();
+                    if (current < buckets[worker].size()) {
+                        for (const auto slot : buckets[worker][current]) {
+                            if (queued_in[slot] == current) {
+                                queued_in[slot] = npos;
+                                frontier.push_back(slot);
+                                if constexpr (is_observed) {
+                                    const Node node = indexer.node(slot);
+                                    observer.popped(node, --open_size);
+                                    observer.expanded(node);
+                                }
+                            }
+                        }
+                        buckets[worker][current].clear();
+                    }
+                    settled[worker].insert(settled[worker].end(), frontier.begin(), frontier.end());
+                    any = any || !frontier.empty();
+                }
+                if (!any) {
+                    break;
+                }
+                relax(frontiers, true);
+            }
+            relax(settled, false);
+        }
+        return tree;
+    }
+}
@@ -1,27 +1,260 @@
 #pragma once
 
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+
 #include "a_star.hpp"
 
 
 namespace algos {
+    template<typename Node>
+    struct ZeroHeuristic {
+        double operator()(const Node&) const noexcept {
+            return 0.0;
+        }
+    };
+
     template<
         std::equality_comparable Node,
         typename Neighboors,
         typename Predicate,
         typename Weight,
-        typename Reconstructor = decltype(reconstruct_path<Node>)
+        typename Reconstructor = decltype(reconstruct_path<Node>),
+        typename Observer = NullSearchObserver
     >
-    requires NeighboorsGetter<Neighboors, Node> 
-        && WeightGetter<Weight, Node> 
+    requires NeighboorsGetter<Neighboors, Node>
+        && WeightGetter<Weight, Node>
         && NodePredicate<Predicate, Node>
+        && PathReconstructor<Reconstructor, Node>
+        && SearchObserver<Observer, Node>
     static NodePath<Node> DijkstraFindPath(
             const Node& from,
             const Predicate& is_searched,
             const Neighboors& get_neighboors,
             const Weight& get_weight,
-            const Reconstructor& reconstructor = reconstruct_path<Node>
+            const Reconstructor& reconstructor = reconstruct_path<Node>,
+            const Observer& observer = {}
     ) {
-        return AStarFindPath(from, is_searched, get_neighboors, get_weight, [](const Node&) { return 0.0; }, reconstructor);
+        return AStarFindPath(from, is_searched, get_neighboors, get_weight, ZeroHeuristic<Node>{}, reconstructor, observer);
     }
-}
 
+    template<
+        std::equality_comparable Node,
+        typename Neighboors,
+        typename Predicate,
+        typename Weight,
+        typename Indexer,
+        typename Reconstructor = decltype(reconstruct_path<Node>),
+        typename Observer = NullSearchObserver
+    >
+    requires NeighboorsGetter<Neighboors, Node>
+        && WeightGetter<Weight, Node>
+        && NodePredicate<Predicate, Node>
+        && NodeIndexer<Indexer, Node>
+        && PathReconstructor<Reconstructor, Node>
+        && SearchObserver<Observer, Node>
+    static NodePath<Node> DijkstraFindPath(
+            const Node& from,
+            const Predicate& is_searched,
+            const Neighboors& get_neighboors,
+            const Weight& get_weight,
+            const Indexer& indexer,
+            const Reconstructor& reconstructor = reconstruct_path<Node>,
+            const Observer& observer = {}
+    ) {
+        return AStarFindPath(from, is_searched, get_neighboors, get_weight, ZeroHeuristic<Node>{}, indexer, reconstructor, observer);
+    }
+
+    template<
+        std::equality_comparable Node,
+        typename Neighboors,
+        typename Predicate,
+        typename Weight,
+        typename Indexer,
+        typename Reconstructor = decltype(reconstruct_path<Node>),
+        typename Observer = NullSearchObserver
+    >
+    requires NeighboorsGetter<Neighboors, Node>
+        && WeightGetter<Weight, Node>
+        && NodePredicate<Predicate, Node>
+        && PathReconstructor<Reconstructor, Node>
+        && SearchObserver<Observer, Node>
+    static NodePath<Node> DijkstraFindPath(
+            const Node& from,
+            const Predicate& is_searched,
+            const Neighboors& get_neighboors,
+            const Weight& get_weight,
+            SearchWorkspace<Node, Indexer>& workspace,
+            const Reconstructor& reconstructor = reconstruct_path<Node>,
+            const Observer& observer = {}
+    ) {
+        return AStarFindPath(from, is_searched, get_neighboors, get_weight, ZeroHeuristic<Node>{}, workspace, reconstructor, observer);
+    }
+
+    // Turns a floating point WeightGetter into fixed-point integer weights for DialFindPath.
+    // Weights are rounded to 1/scale, so paths are optimal up to that precision.
+    template<typename Weight>
+    struct FixedPointWeight {
+        const Weight& get_weight;
+        double scale;
+
+        template<typename Node>
+        uint64_t operator()(const Node& from, const Node& to) const {
+            return uint64_t(std::llround(double(get_weight(from, to)) * scale));
+        }
+
+        uint64_t to_fixed(double weight) const {
+            return uint64_t(std::llround(weight * scale));
+        }
+    };
+
+    namespace detail {
+        template<
+            typename Node,
+            typename Neighboors,
+            typename Predicate,
+            typename Weight,
+            typename Slots,
+            typename Reconstructor,
+            typename Observer = NullSearchObserver
+        >
+        NodePath<Node> dial_search(
+                const Node& from,
+                const Predicate& is_searched,
+                const Neighboors& get_neighboors,
+                const Weight& get_weight,
+                uint64_t max_weight,
+                Slots& slots,
+                const Reconstructor& reconstructor,
+                const Observer& observer = {}
+        ) {
+            struct Record {
+                Node node;
+                uint64_t distance;
+                size_t parent;
+                bool closed;
+            };
+            std::vector<Record> records = { {from, 0, 0, false} };
+            slots.insert(from, 0);
+
+            // every queued distance lies in [current, current + max_weight], so max_weight + 1
+            // buckets indexed by distance modulo their count never mix different distances
+            std::vector<std::vector<size_t>> buckets(size_t(max_weight) + 1);
+            buckets[0].push_back(0);
+            size_t queued = 1;
+            observer.discovered(from);
+            observer.pushed(from, queued);
+
+            for (uint64_t current_distance = 0; queued > 0; ++current_distance) {
+                auto& bucket = buckets[size_t(current_distance % buckets.size())];
+                // zero weight edges may append to the bucket being processed
+                for (size_t i = 0; i < bucket.size(); ++i) {
+                    --queued;
+                    const auto current_index = bucket[i];
+                    observer.popped(records[current_index].node, queued);
+                    if (records[current_index].closed || records[current_index].distance != current_distance) {
+                        // stale entry, the record was improved after it was queued
+                        continue;
+                    }
+                    records[current_index].closed = true;
+                    const auto current = records[current_index];
+                    observer.expanded(current.node);
+
+                    if (is_searched(current.node)) {
+                        std::vector<ReconstructionItem<Node>> parents;
+                        parents.reserve(records.size());
+                        rng::transform(records, std::back_inserter(parents), [](const Record& item) {
+                            return ReconstructionItem{item.node, item.parent};
+                        });
+                        return reconstructor(current.node, parents);
+                    }
+
+                    for (const auto& neighboor : get_neighboors(current.node)) {
+                        const auto weight = uint64_t(get_weight(current.node, neighboor));
+                        if (weight > max_weight) {
+                            throw std::logic_error("DialFindPath: edge weight exceeds max_weight");
+                        }
+                        const auto distance = current.distance + weight;
+                        auto index = slots.find(neighboor);
+                        if (index == npos) {
+                            index = records.size();
+                            slots.insert(neighboor, index);
+                            records.push_back({neighboor, distance, current_index, false});
+                            observer.discovered(neighboor);
+                        } else if (records[index].closed || distance >= records[index].distance) {
+                            continue;
+                        } else {
+                            records[index].distance = distance;
+                            records[index].parent = current_index;
+                            observer.relaxed(current.node, neighboor);
+                        }
+                        buckets[size_t(distance % buckets.size())].push_back(index);
+                        ++queued;
+                        observer.pushed(neighboor, queued);
+                    }
+                }
+                bucket.clear();
+            }
+            return {};
+        }
+    }
+
+    // Dijkstra over a circular bucket queue (Dial's algorithm).
+    // Requires non-negative integer weights bounded by max_weight, runs in O(E + V + D)
+    // where D is the distance to the searched node.
+    template<
+        std::equality_comparable Node,
+        typename Neighboors,
+        typename Predicate,
+        typename Weight,
+        typename Reconstructor = decltype(reconstruct_path<Node>),
+        typename Observer = NullSearchObserver
+    >
+    requires NeighboorsGetter<Neighboors, Node>
+        && IntegerWeightGetter<Weight, Node>
+        && NodePredicate<Predicate, Node>
+        && PathReconstructor<Reconstructor, Node>
+        && SearchObserver<Observer, Node>
+    static NodePath<Node> DialFindPath(
+            const Node& from,
+            const Predicate& is_searched,
+            const Neighboors& get_neighboors,
+            const Weight& get_weight,
+            uint64_t max_weight,
+            const Reconstructor& reconstructor = reconstruct_path<Node>,
+            const Observer& observer = {}
+    ) {
+        LinearNodeSlots<Node> slots;
+        return detail::dial_search(from, is_searched, get_neighboors, get_weight, max_weight, slots, reconstructor, observer);
+    }
+
+    template<
+        std::equality_comparable Node,
+        typename Neighboors,
+        typename Predicate,
+        typename Weight,
+        typename Indexer,
+        typename Reconstructor = decltype(reconstruct_path<Node>),
+        typename Observer = NullSearchObserver
+    >
+    requires NeighboorsGetter<Neighboors, Node>
+        && IntegerWeightGetter<Weight, Node>
+        && NodePredicate<Predicate, Node>
+        && NodeIndexer<Indexer, Node>
+        && PathReconstructor<Reconstructor, Node>
+        && SearchObserver<Observer, Node>
+    static NodePath<Node> DialFindPath(
+            const Node& from,
+            const Predicate& is_searched,
+            const Neighboors& get_neighboors,
+            const Weight& get_weight,
+            uint64_t max_weight,
+            const Indexer& indexer,
+            const Reconstructor& reconstructor = reconstruct_path<Node>,
+            const Observer& observer = {}
+    ) {
+        DenseNodeSlots<Node, Indexer> slots(indexer);
+        return detail::dial_search(from, is_searched, get_neighboors, get_weight, max_weight, slots, reconstructor, observer);
+    }
+}
@@ -0,0 +1,243 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <vector>
+
+#include <maze/maze.hpp>
+
+#include "search_algos_util.hpp"
+#include "indexed_heap.hpp"
+
+
+namespace algos {
+    // Distances from every cell to the maze finish (`maze.to`), found by one reverse Dijkstra,
+    // with the first step of a shortest path stored per cell. Paths of any number of agents
+    // sharing the finish are then read in O(path length) without searching.
+    // Cells take 5 bytes: a float distance and the direction of the next step.
+    //
+    // The neighbourhood has to be symmetric and made of adjacent cells, like every Maze neighbourhood.
+    // Edits made through Maze are noticed on the next query and rebuild the whole field,
+    // reporting edited cells with `cells_changed` repairs only the part of it they can affect.
+    template<typename Neighboors, typename Weight>
+    requires NeighboorsGetter<Neighboors, Maze::Node> && WeightGetter<Weight, Maze::Node>
+    class DistanceField {
+    public:
+        using Node = Maze::Node;
+
+        DistanceField(const Maze& maze, Neighboors get_neighboors, Weight get_weight)
+            : m_maze(maze)
+            , m_get_neighboors(std::move(get_neighboors))
+            , m_get_weight(std::move(get_weight)) {}
+
+        // Reports cells edited since `revision_before_edit`, so only distances depending on them are recomputed.
+        // Ignored if the maze had other edits since the field was last updated.
+        void cells_changed(const std::vector<Node>& cells, uint64_t revision_before_edit) {
+            if (m_revision == revision_before_edit && m_maze.width == m_width && m_maze.height == m_height) {
+                m_changed.insert(m_changed.end(), cells.begin(), cells.end());
+                m_revision = m_maze.revision;
+            }
+        }
+
+        bool is_reachable(const Node& node) {
+            update();
+            return m_maze.is_valid(node) && m_distances[slot_of(node)] != infinity;
+        }
+
+        // cost of the shortest path from `node` to the finish, infinity if there is none
+        float distance(const Node& node) {
+            return is_reachable(node) ? m_distances[slot_of(node)] : infinity;
+        }
+
+        // greatest finite distance, 0 if nothing reaches the finish
+        float max_distance() {
+            update();
+            float result = 0.0f;
+            for (const auto distance : m_distances) {
+                if (distance != infinity) {
+                    result = std::max(result, distance);
+                }
+            }
+            return result;
+        }
+
+        // cell to move to from `node`, none for the finish and unreachable cells
+        std::optional<Node> next_step(const Node& node) {
+            if (!is_reachable(node) || m_directions[slot_of(node)] == no_direction) {
+                return std::nullopt;
+            }
+            return step(node, m_directions[slot_of(node)]);
+        }
+
+        // Path from the finish back to `from`, like reconstruct_path. Empty if `from` is unreachable
+        NodePath<Node> path_from(const Node& from) {
+            if (!is_reachable(from)) {
+                return {};
+            }
+            NodePath<Node> path = { from };
+            for (auto direction = m_directions[slot_of(from)]; direction != no_direction; direction = m_directions[slot_of(path.back())]) {
+                path.push_back(step(path.back(), direction));
+            }
+            rng::reverse(path);
+            return path;
+        }
+
+        // Brings the field up to date now rather than on the next query
+        void update() {
+            if (m_revision != m_maze.revision || m_width != m_maze.width || m_height != m_maze.height || m_goal != m_maze.to) {
+                rebuild();
+            } else if (!m_changed.empty()) {
+                repair();
+            }
+            m_changed.clear();
+        }
+
+    private:
+        static constexpr float infinity = std::numeric_limits<float>::infinity();
+        // directions are (dx + 1) * 3 + (dy + 1)
+        static constexpr uint8_t no_direction = 0xFF;
+
+        const Maze& m_maze;
+        Neighboors m_get_neighboors;
+        Weight m_get_weight;
+        size_t m_width = 0;
+        size_t m_height = 0;
+        size_t m_goal = npos;
+        // maze revision the field was built for, 0 if never built
+        uint64_t m_revision = 0;
+        std::vector<float> m_distances;
+        std::vector<uint8_t> m_directions;
+        // reported since the last update
+        std::vector<Node> m_changed;
+        // kept between updates, so repairs do not allocate a position table for the whole maze
+        IndexedHeap<double> m_open;
+
+        size_t slot_of(const Node& node) const {
+            return node.y * m_width + node.x;
+        }
+
+        static uint8_t direction(const Node& from, const Node& to) {
+            const auto dx = ptrdiff_t(to.x) - ptrdiff_t(from.x);
+            const auto dy = ptrdiff_t(to.y) - ptrdiff_t(from.y);
+            if (std::abs(dx) > 1 || std::abs(dy) > 1) {
+                throw std::logic_error("DistanceField: neighboors have to be adjacent cells");
+            }
+            return uint8_t((dx + 1) * 3 + dy + 1);
+        }
+
+        static Node step(const Node& node, uint8_t direction) {
+            return { node.x + direction / 3 - 1, node.y + direction % 3 - 1 };
+        }
+
+        // the cell itself and cells around it, inside the maze
+        template<typename Callback>
+        void for_each_cell_around(const Node& node, const Callback& callback) const {
+            for (size_t y = node.y == 0 ? 0 : node.y - 1; y <= std::min(node.y + 1, m_height - 1); ++y) {
+                for (size_t x = node.x == 0 ? 0 : node.x - 1; x <= std::min(node.x + 1, m_width - 1); ++x) {
+                    callback(Node{x, y});
+                }
+            }
+        }
+
+        void rebuild() {
+            m_width = m_maze.width;
+            m_height = m_maze.height;
+            m_goal = m_maze.to;
+            m_revision = m_maze.revision;
+            m_distances.assign(m_maze.cell_count(), infinity);
+            m_directions.assign(m_maze.cell_count(), no_direction);
+            if (m_goal >= m_maze.cell_count() || m_maze.get_cell(m_goal) == MazeObject::wall) {
+                return;
+            }
+            m_distances[m_goal] = 0.0f;
+            m_open.push(m_goal, 0.0);
+            propagate();
+        }
+
+        // Dijkstra from everything in `m_open`, lowering distances it can improve
+        void propagate() {
+            while (!m_open.empty()) {
+                const auto slot = m_open.pop();
+                const Node node{slot % m_width, slot / m_width};
+                const double distance = m_distances[slot];
+                for (const Node& neighboor : m_get_neighboors(node)) {
+                    // neighbourhoods are symmetric, so this is the move from `neighboor` to `node`
+                    const auto candidate = float(distance + double(m_get_weight(neighboor, node)));
+                    const auto target = slot_of(neighboor);
+                    if (candidate < m_distances[target]) {
+                        m_distances[target] = candidate;
+                        m_directions[target] = direction(neighboor, node);
+                        m_open.push_or_decrease(target, double(candidate));
+                    }
+                }
+            }
+        }
+
+        bool is_move(const Node& from, const Node& to) const {
+            const auto neighboors = m_get_neighboors(from);
+            return !m_maze.is_wall(from) && rng::find(neighboors, to) != rng::end(neighboors);
+        }
+
+        // Edits can only lengthen paths going through edited cells or through moves next to them
+        // (corner cutting depends on cells around a move). Those cells and everything whose path
+        // leads through them are cleared, then distances flow back in from cells around the cleared area.
+        // Paths can also get shorter only through the edited area, so those cells seed the search too.
+        void repair() {
+            for (const auto& cell : m_changed) {
+                if (slot_of(cell) == m_goal) {
+                    rebuild();
+                    return;
+                }
+            }
+
+            std::vector<Node> cleared;
+            auto clear = [&](const Node& node) {
+                const auto slot = slot_of(node);
+                if (m_distances[slot] != infinity) {
+                    m_distances[slot] = infinity;
+                    m_directions[slot] = no_direction;
+                    cleared.push_back(node);
+                }
+            };
+            for (const auto& cell : m_changed) {
+                clear(cell);
+                for_each_cell_around(cell, [&](const Node& node) {
+                    const auto direction = m_directions[slot_of(node)];
+                    if (direction != no_direction && !is_move(node, step(node, direction))) {
+                        clear(node);
+                    }
+                });
+            }
+            // cells leading into cleared ones, found through their stored directions
+            for (size_t i = 0; i < cleared.size(); ++i) {
+                const auto parent = cleared[i];
+                for_each_cell_around(parent, [&](const Node& node) {
+                    const auto direction = m_directions[slot_of(node)];
+                    if (direction != no_direction && step(node, direction) == parent) {
+                        clear(node);
+                    }
+                });
+            }
+
+            auto seed_around = [&](const Node& cell) {
+                for_each_cell_around(cell, [&](const Node& node) {
+                    const auto slot = slot_of(node);
+                    if (m_distances[slot] != infinity && !m_open.contains(slot)) {
+                        m_open.push(slot, double(m_distances[slot]));
+                    }
+                });
+            };
+            for (const auto& cell : cleared) {
+                seed_around(cell);
+            }
+            for (const auto& cell : m_changed) {
+                seed_around(cell);
+            }
+            propagate();
+        }
+    };
+}
@@ -0,0 +1,548 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include <maze/maze.hpp>
+#include <util/static_vector.hpp>
+
+#include "search_algos_util.hpp"
+#include "search_observer.hpp"
+#include "dijkstra.hpp"
+
+
+namespace algos {
+    // HPA* (Botea, Mueller, Schaeffer): the maze is cut into square clusters, cells where paths cross
+    // cluster borders become entrances of a small abstract graph, and distances between entrances
+    // of every cluster are precomputed. Queries search the abstract graph, then refine each of its edges
+    // with a search limited to a single cluster. Paths are near-optimal: they cross borders only at entrances.
+    //
+    // The neighbourhood has to be symmetric, include side moves between free cells and have at most
+    // 8 neighboors per cell, like every Maze neighbourhood.
+    // Edits made through Maze are noticed on the next query and rebuild the whole abstraction,
+    // reporting edited cells with `cells_changed` limits that to the clusters around them.
+    template<typename Neighboors, typename Weight>
+    requires NeighboorsGetter<Neighboors, Maze::Node> && WeightGetter<Weight, Maze::Node>
+    class HierarchicalPathfinder {
+    public:
+        using Node = Maze::Node;
+
+        HierarchicalPathfinder(const Maze& maze, Neighboors get_neighboors, Weight get_weight, size_t cluster_size = 32)
+            : m_maze(maze)
+            , m_get_neighboors(std::move(get_neighboors))
+            , m_get_weight(std::move(get_weight))
+            , m_cluster_size(cluster_size) {}
+
+        // Reports cells edited since `revision_before_edit`, so only clusters around them are rebuilt.
+        // Ignored if the maze had other edits since the abstraction was last updated.
+        void cells_changed(const std::vector<Node>& cells, uint64_t revision_before_edit) {
+            if (m_revision == revision_before_edit && m_maze.width == m_width && m_maze.height == m_height) {
+                for (const auto& cell : cells) {
+                    m_dirty[cluster_of(cell)] = true;
+                }
+                m_revision = m_maze.revision;
+            }
+        }
+
+        size_t cluster_count() const {
+            return m_clusters.size();
+        }
+
+        size_t entrance_count() {
+            update();
+            size_t count = 0;
+            for (const auto& cluster : m_clusters) {
+                count += cluster.entrances.size();
+            }
+            return count;
+        }
+
+        // Path from `to` back to `from`, like reconstruct_path.
+        // `heuristic` estimates distance to `to`. `on_expand` gets cells of expanded abstract nodes,
+        // `observer` sees the abstract search with its nodes given as cells too. Refinements are not reported.
+        template<
+            typename Heuristic = ZeroHeuristic<Node>,
+            typename OnExpand = EmptyUpdate<Node>,
+            typename Observer = NullSearchObserver
+        >
+        requires HeuristicGetter<Heuristic, Node> && SearchObserver<Observer, Node>
+        NodePath<Node> find_path(
+                const Node& from,
+                const Node& to,
+                const Heuristic& heuristic = {},
+                const OnExpand& on_expand = {},
+                const Observer& observer = {}
+        ) {
+            update();
+            if (!m_maze.is_valid(from) || !m_maze.is_valid(to) || m_maze.is_wall(from) || m_maze.is_wall(to)) {
+                return {};
+            }
+            if (from == to) {
+                return { from };
+            }
+
+            // start and goal join the abstract graph only for this query
+            const auto from_cluster = cluster_of(from);
+            const auto to_cluster = cluster_of(to);
+            auto start_targets = m_clusters[from_cluster].entrances;
+            if (from_cluster == to_cluster) {
+                start_targets.push_back(to);
+            }
+            const auto from_distances = cluster_distances(from_cluster, from, start_targets, false);
+            const auto to_distances = cluster_distances(to_cluster, to, m_clusters[to_cluster].entrances, true);
+
+            std::vector<size_t> offsets = { 0 };
+            for (const auto& cluster : m_clusters) {
+                offsets.push_back(offsets.back() + cluster.entrances.size());
+            }
+            const auto start = offsets.back();
+            const auto goal = start + 1;
+            // cluster of an entrance id
+            auto cluster_of_id = [&](size_t id) {
+                return size_t(rng::upper_bound(offsets, id) - offsets.begin()) - 1;
+            };
+            auto cell_of = [&](size_t id) {
+                if (id >= start) {
+                    return id == start ? from : to;
+                }
+                const auto cluster = cluster_of_id(id);
+                return m_clusters[cluster].entrances[id - offsets[cluster]];
+            };
+
+            // neighboors of the last expanded node, the buffer is reused between expansions
+            std::vector<size_t> neighboors;
+            auto add_neighboor = [&](size_t id, double weight) {
+                if (weight < infinity) {
+                    neighboors.push_back(id);
+                }
+            };
+            auto get_neighboors = [&](size_t id) -> const std::vector<size_t>& {
+                neighboors.clear();
+                if (id == start) {
+                    for (size_t i = 0; i < from_distances.size(); ++i) {
+                        add_neighboor(i < m_clusters[from_cluster].entrances.size() ? offsets[from_cluster] + i : goal, from_distances[i]);
+                    }
+                    return neighboors;
+                }
+                if (id == goal) {
+                    return neighboors;
+                }
+                const auto cluster_index = cluster_of_id(id);
+                const auto& cluster = m_clusters[cluster_index];
+                const auto entrance = id - offsets[cluster_index];
+                const auto count = cluster.entrances.size();
+                for (size_t other = 0; other < count; ++other) {
+                    if (other != entrance) {
+                        add_neighboor(offsets[cluster_index] + other, cluster.distances[entrance * count + other]);
+                    }
+                }
+                for (const auto& outside : cluster.crossings[entrance]) {
+                    const auto outside_cluster = cluster_of(outside);
+                    const auto& outside_entrances = m_clusters[outside_cluster].entrances;
+                    const auto outside_entrance = size_t(rng::find(outside_entrances, outside) - outside_entrances.begin());
+                    if (outside_entrance == outside_entrances.size()) {
+                        continue;
+                    }
+                    add_neighboor(offsets[outside_cluster] + outside_entrance, double(m_get_weight(cluster.entrances[entrance], outside)));
+                }
+                if (cluster_index == to_cluster) {
+                    add_neighboor(goal, to_distances[entrance]);
+                }
+                return neighboors;
+            };
+            // same costs get_neighboors filters edges by, found from both ends of the edge alone
+            auto get_weight = [&](size_t from_id, size_t to_id) {
+                if (from_id == start) {
+                    // the goal follows entrances of the start cluster in `start_targets`
+                    return from_distances[to_id == goal ? m_clusters[from_cluster].entrances.size() : to_id - offsets[from_cluster]];
+                }
+                const auto cluster_index = cluster_of_id(from_id);
+                const auto entrance = from_id - offsets[cluster_index];
+                if (to_id == goal) {
+                    return to_distances[entrance];
+                }
+                const auto& cluster = m_clusters[cluster_index];
+                if (cluster_of_id(to_id) == cluster_index) {
+                    return cluster.distances[entrance * cluster.entrances.size() + to_id - offsets[cluster_index]];
+                }
+                // border crossing is a single move
+                return double(m_get_weight(cluster.entrances[entrance], cell_of(to_id)));
+            };
+            auto is_searched = [&](size_t id) {
+                on_expand(cell_of(id));
+                return id == goal;
+            };
+            auto get_heuristic = [&](size_t id) {
+                return double(heuristic(cell_of(id)));
+            };
+            const auto abstract_path = AStarFindPath(
+                start, is_searched, get_neighboors, get_weight, get_heuristic, IdIndexer{goal + 1},
+                reconstruct_path<size_t>, CellObserver<Observer, decltype(cell_of)>{observer, cell_of}
+            );
+            if (abstract_path.empty()) {
+                return {};
+            }
+
+            // abstract path goes from goal to start, so is the refined one
+            NodePath<Node> path = { to };
+            for (size_t i = 1; i < abstract_path.size(); ++i) {
+                const auto current = cell_of(abstract_path[i - 1]);
+                const auto next = cell_of(abstract_path[i]);
+                if (cluster_of(current) != cluster_of(next)) {
+                    // border crossing is a single move
+                    path.push_back(next);
+                    continue;
+                }
+                const auto cluster = cluster_of(current);
+                const auto part = DijkstraFindPath(next, Equals<Node>{current}, ClusterNeighboors{this, cluster, nullptr}, m_get_weight, cluster_indexer(cluster));
+                // part goes from current to next
+                path.insert(path.end(), part.begin() + 1, part.end());
+            }
+            return path;
+        }
+
+    private:
+        static constexpr double infinity = std::numeric_limits<double>::infinity();
+        // weight of edges to the virtual sink, bigger than any real path inside a cluster
+        static constexpr double sink_weight = std::numeric_limits<double>::max() / 4;
+        static inline const Node sink = Node{npos, npos};
+
+        // two cells next to each other on the opposite sides of a cluster border
+        struct Transition {
+            Node inside;
+            Node outside;
+        };
+
+        struct Cluster {
+            std::vector<Node> entrances;
+            // cells in other clusters reachable in one move, per entrance
+            std::vector<std::vector<Node>> crossings;
+            // distances[from * entrances.size() + to] inside the cluster, infinity if there is no path
+            std::vector<double> distances;
+            // border transitions found on the right and the bottom side of the cluster
+            std::array<std::vector<Transition>, 2> borders;
+        };
+
+        // Reports abstract nodes to an observer of cells
+        template<typename Observer, typename CellOf>
+        struct CellObserver {
+            const Observer& observer;
+            const CellOf& cell_of;
+
+            void expanded(size_t id) const {
+                observer.expanded(cell_of(id));
+            }
+
+            void discovered(size_t id) const {
+                observer.discovered(cell_of(id));
+            }
+
+            void pushed(size_t id, size_t open_size) const {
+                observer.pushed(cell_of(id), open_size);
+            }
+
+            void popped(size_t id, size_t open_size) const {
+                observer.popped(cell_of(id), open_size);
+            }
+
+            void relaxed(size_t from_id, size_t to_id) const {
+                observer.relaxed(cell_of(from_id), cell_of(to_id));
+            }
+        };
+
+        struct IdIndexer {
+            size_t count;
+
+            size_t operator()(size_t id) const {
+                return id;
+            }
+
+            size_t size() const {
+                return count;
+            }
+        };
+
+        // Cells of a single cluster, plus the virtual sink in the last slot
+        struct ClusterIndexer {
+            size_t x0;
+            size_t y0;
+            size_t width;
+            size_t height;
+
+            size_t operator()(const Node& node) const {
+                return node == sink ? width * height : (node.y - y0) * width + (node.x - x0);
+            }
+
+            size_t size() const {
+                return width * height + 1;
+            }
+        };
+
+        // Neighboors inside one cluster. Cells marked in `targets` also lead to the sink.
+        struct ClusterNeighboors {
+            const HierarchicalPathfinder* pathfinder;
+            size_t cluster;
+            const std::vector<bool>* targets;
+
+            util::StaticVector<Node, 9> operator()(const Node& node) const {
+                util::StaticVector<Node, 9> result;
+                if (node == sink) {
+                    return result;
+                }
+                for (const auto& neighboor : pathfinder->m_get_neighboors(node)) {
+                    if (pathfinder->cluster_of(neighboor) == cluster) {
+                        result.push_back(neighboor);
+                    }
+                }
+                if (targets != nullptr && (*targets)[pathfinder->cluster_indexer(cluster)(node)]) {
+                    result.push_back(sink);
+                }
+                return result;
+            }
+        };
+
+        const Maze& m_maze;
+        Neighboors m_get_neighboors;
+        Weight m_get_weight;
+        size_t m_cluster_size;
+        size_t m_width = 0;
+        size_t m_height = 0;
+        size_t m_clusters_x = 0;
+        size_t m_clusters_y = 0;
+        // maze revision the abstraction was built for, 0 if never built
+        uint64_t m_revision = 0;
+        std::vector<Cluster> m_clusters;
+        std::vector<bool> m_dirty;
+
+        size_t cluster_of(const Node& node) const {
+            return (node.y / m_cluster_size) * m_clusters_x + node.x / m_cluster_size;
+        }
+
+        ClusterIndexer cluster_indexer(size_t cluster) const {
+            const auto x0 = (cluster % m_clusters_x) * m_cluster_size;
+            const auto y0 = (cluster / m_clusters_x) * m_cluster_size;
+            return { x0, y0, std::min(m_cluster_size, m_width - x0), std::min(m_cluster_size, m_height - y0) };
+        }
+
+        bool is_free(const Node& node) const {
+            return m_maze.is_valid(node) && !m_maze.is_wall(node);
+        }
+
+        void update() {
+            if (m_revision != m_maze.revision || m_width != m_maze.width || m_height != m_maze.height) {
+                m_width = m_maze.width;
+                m_height = m_maze.height;
+                m_clusters_x = (m_width + m_cluster_size - 1) / m_cluster_size;
+                m_clusters_y = (m_height + m_cluster_size - 1) / m_cluster_size;
+                m_clusters.assign(m_clusters_x * m_clusters_y, {});
+                m_dirty.assign(m_clusters.size(), true);
+                m_revision = m_maze.revision;
+            }
+            if (rng::find(m_dirty, true) == m_dirty.end()) {
+                return;
+            }
+
+            // Border transitions of a cluster depend on cells of its neighboors, so dirty
+            // clusters have all their neighboors rescanned. Transitions found by those scans end in
+            // clusters at most one step away from them, but only the ones next to edited clusters can change.
+            std::vector<bool> affected(m_clusters.size(), false);
+            for (size_t cluster = 0; cluster < m_clusters.size(); ++cluster) {
+                if (!m_dirty[cluster]) {
+                    continue;
+                }
+                for_each_cluster_around(cluster, [&](size_t other) {
+                    affected[other] = true;
+                });
+            }
+            for (size_t cluster = 0; cluster < m_clusters.size(); ++cluster) {
+                if (affected[cluster]) {
+                    scan_borders(cluster);
+                }
+            }
+            for (size_t cluster = 0; cluster < m_clusters.size(); ++cluster) {
+                if (affected[cluster]) {
+                    rebuild_entrances(cluster);
+                }
+            }
+            m_dirty.assign(m_clusters.size(), false);
+        }
+
+        // the cluster itself and up to 8 clusters around it
+        template<typename Callback>
+        void for_each_cluster_around(size_t cluster, const Callback& callback) const {
+            const auto cx = cluster % m_clusters_x;
+            const auto cy = cluster / m_clusters_x;
+            for (size_t y = cy == 0 ? 0 : cy - 1; y <= std::min(cy + 1, m_clusters_y - 1); ++y) {
+                for (size_t x = cx == 0 ? 0 : cx - 1; x <= std::min(cx + 1, m_clusters_x - 1); ++x) {
+                    callback(y * m_clusters_x + x);
+                }
+            }
+        }
+
+        bool is_move(const Node& from, const Node& to) const {
+            if (!is_free(from) || !is_free(to)) {
+                return false;
+            }
+            for (const auto& neighboor : m_get_neighboors(from)) {
+                if (neighboor == to) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        // Moves crossing the right (side 0) or the bottom (side 1) border of a cluster, grouped in runs
+        // of parallel moves into the same cluster. Cells of a run are connected by side moves on both sides
+        // of the border, so one transition per run keeps connectivity. Long runs get one at each end.
+        void scan_borders(size_t cluster) {
+            const auto bounds = cluster_indexer(cluster);
+            for (size_t side = 0; side < 2; ++side) {
+                auto& transitions = m_clusters[cluster].borders[side];
+                transitions.clear();
+                const bool is_right = side == 0;
+                if ((is_right ? bounds.x0 + bounds.width : bounds.y0 + bounds.height) >= (is_right ? m_width : m_height)) {
+                    continue;
+                }
+                const auto length = is_right ? bounds.height : bounds.width;
+                auto border_move = [&](size_t position, int shift) {
+                    if (is_right) {
+                        const Node inside{bounds.x0 + bounds.width - 1, bounds.y0 + position};
+                        return Transition{inside, Node{inside.x + 1, size_t(ptrdiff_t(inside.y) + shift)}};
+                    }
+                    const Node inside{bounds.x0 + position, bounds.y0 + bounds.height - 1};
+                    return Transition{inside, Node{size_t(ptrdiff_t(inside.x) + shift), inside.y + 1}};
+                };
+                for (int shift = -1; shift <= 1; ++shift) {
+                    size_t run_start = 0;
+                    size_t run_length = 0;
+                    size_t run_cluster = npos;
+                    auto close_run = [&] {
+                        if (run_length == 0) {
+                            return;
+                        }
+                        const size_t long_run = 6;
+                        if (run_length < long_run) {
+                            transitions.push_back(border_move(run_start + run_length / 2, shift));
+                        } else {
+                            transitions.push_back(border_move(run_start, shift));
+                            transitions.push_back(border_move(run_start + run_length - 1, shift));
+                        }
+                        run_length = 0;
+                    };
+                    for (size_t position = 0; position < length; ++position) {
+                        const auto move = border_move(position, shift);
+                        if (!is_move(move.inside, move.outside)) {
+                            close_run();
+                            continue;
+                        }
+                        const auto outside_cluster = cluster_of(move.outside);
+                        if (run_length > 0 && outside_cluster != run_cluster) {
+                            close_run();
+                        }
+                        if (run_length == 0) {
+                            run_start = position;
+                            run_cluster = outside_cluster;
+                        }
+                        ++run_length;
+                    }
+                    close_run();
+                }
+            }
+        }
+
+        void rebuild_entrances(size_t cluster) {
+            // (entrance, cell behind the border) pairs from the scans of this cluster and its neighboors
+            std::vector<std::pair<Node, Node>> pairs;
+            for_each_cluster_around(cluster, [&](size_t other) {
+                for (const auto& transitions : m_clusters[other].borders) {
+                    for (const auto& [inside, outside] : transitions) {
+                        if (other == cluster) {
+                            pairs.push_back({inside, outside});
+                        } else if (cluster_of(outside) == cluster) {
+                            pairs.push_back({outside, inside});
+                        }
+                    }
+                }
+            });
+            rng::sort(pairs);
+            pairs.erase(std::unique(pairs.begin(), pairs.end()), pairs.end());
+
+            auto& current = m_clusters[cluster];
+            current.entrances.clear();
+            current.crossings.clear();
+            for (const auto& [entrance, outside] : pairs) {
+                if (current.entrances.empty() || current.entrances.back() != entrance) {
+                    current.entrances.push_back(entrance);
+                    current.crossings.emplace_back();
+                }
+                current.crossings.back().push_back(outside);
+            }
+
+            const auto count = current.entrances.size();
+            current.distances.assign(count * count, infinity);
+            for (size_t from = 0; from < count; ++from) {
+                const auto distances = cluster_distances(cluster, current.entrances[from], current.entrances, false);
+                rng::copy(distances, current.distances.begin() + ptrdiff_t(from * count));
+            }
+        }
+
+        // Shortest distances inside `cluster` from `source` to each of `targets`, infinity for unreachable ones.
+        // `reversed` gives distances from targets to the source instead.
+        // Done by a single DijkstraFindPath that stops once every target is settled. A virtual sink behind
+        // every target is settled right after all reachable ones, so the search ends through the reconstructor
+        // with final distances even when some targets can not be reached.
+        std::vector<double> cluster_distances(size_t cluster, const Node& source, const std::vector<Node>& targets, bool reversed) const {
+            std::vector<double> distances(targets.size(), infinity);
+            if (targets.empty()) {
+                return distances;
+            }
+            const auto indexer = cluster_indexer(cluster);
+            std::vector<bool> is_target(indexer.size(), false);
+            for (const auto& target : targets) {
+                is_target[indexer(target)] = true;
+            }
+
+            auto get_weight = [&](const Node& from, const Node& to) {
+                if (to == sink) {
+                    return sink_weight;
+                }
+                return double(reversed ? m_get_weight(to, from) : m_get_weight(from, to));
+            };
+            const auto target_count = size_t(rng::count(is_target, true));
+            std::vector<bool> is_settled(indexer.size(), false);
+            size_t settled_count = 0;
+            auto is_searched = [&](const Node& node) {
+                const auto slot = indexer(node);
+                if (is_target[slot] && !is_settled[slot]) {
+                    is_settled[slot] = true;
+                    ++settled_count;
+                }
+                return node == sink || settled_count == target_count;
+            };
+            auto reconstructor = [&](const Node&, const std::vector<ReconstructionItem<Node>>& parents) {
+                for (size_t record = 0; record < parents.size(); ++record) {
+                    if (!is_target[indexer(parents[record].child)]) {
+                        continue;
+                    }
+                    double distance = 0.0;
+                    for (auto index = record; parents[index].parent_index != index; index = parents[index].parent_index) {
+                        distance += get_weight(parents[parents[index].parent_index].child, parents[index].child);
+                    }
+                    const auto target = size_t(rng::find(targets, parents[record].child) - targets.begin());
+                    distances[target] = distance;
+                }
+                return NodePath<Node>{};
+            };
+            DijkstraFindPath(source, is_searched, ClusterNeighboors{this, cluster, &is_target}, get_weight, indexer, reconstructor);
+            // targets can repeat, e.g. when the goal is an entrance too
+            for (size_t i = 0; i < targets.size(); ++i) {
+                const auto first = size_t(rng::find(targets, targets[i]) - targets.begin());
+                distances[i] = distances[first];
+            }
+            return distances;
+        }
+    };
+}
@@ -0,0 +1,155 @@
+#pragma once
+
+#include <vector>
+#include <limits>
+#include <cstddef>
+#include <utility>
+
+
+namespace algos {
+    // Binary min-heap over integer keys with O(log n) decrease-key.
+    // Keys are expected to be dense (record indices), the position table grows to the largest key pushed.
+    template<typename Priority = double>
+    class IndexedHeap {
+    public:
+        static constexpr size_t npos = std::numeric_limits<size_t>::max();
+
+        bool empty() const {
+            return m_heap.empty();
+        }
+
+        size_t size() const {
+            return m_heap.size();
+        }
+
+        bool contains(size_t key) const {
+            return key < m_positions.size() && m_positions[key] != npos;
+        }
+
+        Priority priority(size_t key) const {
+            return m_heap[m_positions[key]].priority;
+        }
+
+        size_t top() const {
+            return m_heap.front().key;
+        }
+
+        const Priority& top_priority() const {
+            return m_heap.front().priority;
+        }
+
+        void push(size_t key, Priority priority) {
+            if (key >= m_positions.size()) {
+                m_positions.resize(key + 1, npos);
+            }
+            m_positions[key] = m_heap.size();
+            m_heap.push_back({ std::move(priority), key });
+            sift_up(m_heap.size() - 1);
+        }
+
+        // priority must not be greater than the current one
+        void decrease_key(size_t key, Priority priority) {
+            const auto position = m_positions[key];
+            m_heap[position].priority = std::move(priority);
+            sift_up(position);
+        }
+
+        void push_or_decrease(size_t key, Priority priority) {
+            if (contains(key)) {
+                decrease_key(key, std::move(priority));
+            } else {
+                push(key, std::move(priority));
+            }
+        }
+
+        // priority may go either way
+        void update(size_t key, Priority priority) {
+            const auto position = m_positions[key];
+            m_heap[position].priority = std::move(priority);
+            sift_up(position);
+            sift_down(m_positions[key]);
+        }
+
+        void erase(size_t key) {
+            const auto position = m_positions[key];
+            m_positions[key] = npos;
+            if (position + 1 == m_heap.size()) {
+                m_heap.pop_back();
+                return;
+            }
+            const auto moved = m_heap.back().key;
+            place(position, std::move(m_heap.back()));
+            m_heap.pop_back();
+            sift_up(position);
+            sift_down(m_positions[moved]);
+        }
+
+        size_t pop() {
+            const auto key = m_heap.front().key;
+            m_positions[key] = npos;
+            if (m_heap.size() > 1) {
+                m_heap.front() = std::move(m_heap.back());
+                m_positions[m_heap.front().key] = 0;
+                m_heap.pop_back();
+                sift_down(0);
+            } else {
+                m_heap.pop_back();
+            }
+            return key;
+        }
+
+        void clear() {
+            for (const auto& entry : m_heap) {
+                m_positions[entry.key] = npos;
+            }
+            m_heap.clear();
+        }
+
+    private:
+        struct Entry {
+            Priority priority;
+            size_t key;
+        };
+
+        std::vector<Entry> m_heap;
+        std::vector<size_t> m_positions;
+
+        void place(size_t position, Entry entry) {
+            m_positions[entry.key] = position;
+            m_heap[position] = std::move(entry);
+        }
+
+        void sift_up(size_t position) {
+            auto entry = std::move(m_heap[position]);
+            while (position > 0) {
+                const auto parent = (position - 1) / 2;
+                if (!(entry.priority < m_heap[parent].priority)) {
+                    break;
+                }
+                place(position, std::move(m_heap[parent]));
+                position = parent;
+            }
+            place(position, std::move(entry));
+        }
+
+        void sift_down(size_t position) {
+            auto entry = std::move(m_heap[position]);
+            const auto size = m_heap.size();
+            while (true) {
+                auto child = 2 * position + 1;
+                if (child >= size) {
+                    break;
+                }
+                if (child + 1 < size && m_heap[child + 1].priority < m_heap[child].priority) {
+                    ++child;
+                }
+                if (!(m_heap[child].priority < entry.priority)) {
+                    break;
+                }
+                place(position, std::move(m_heap[child]));
+                position = child;
+            }
+            place(position, std::move(entry));
+        }
+    };
+}
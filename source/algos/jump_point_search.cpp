@@ -0,0 +1,259 @@
+#include "jump_point_search.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include <util/util.hpp>
+
+
+namespace algos {
+    static int sign(ptrdiff_t value) {
+        return int(value > 0) - int(value < 0);
+    }
+
+    // index in the per cell array of jump distances
+    static size_t straight_slot(int dx, int dy) {
+        if (dx != 0) {
+            return dx > 0 ? 0 : 1;
+        }
+        return dy > 0 ? 2 : 3;
+    }
+
+    JumpPointSearch::JumpPointSearch(const Maze& maze, bool corners_require_adjacent, bool precompute_jumps)
+        : m_maze(maze)
+        , m_corners_require_adjacent(corners_require_adjacent)
+        , m_precompute_jumps(precompute_jumps) {}
+
+    void JumpPointSearch::invalidate() {
+        m_jump_distances_revision.reset();
+    }
+
+    double JumpPointSearch::octile_distance(const Maze::Node& from, const Maze::Node& to) {
+        const auto dx = from.x > to.x ? from.x - to.x : to.x - from.x;
+        const auto dy = from.y > to.y ? from.y - to.y : to.y - from.y;
+        const auto [straight, diagonal] = std::minmax(dx, dy);
+        return double(diagonal - straight) + double(straight) * 1.4142135623730951;
+    }
+
+    bool JumpPointSearch::is_free(ptrdiff_t x, ptrdiff_t y) const {
+        return x >= 0 && y >= 0
+            && size_t(x) < m_maze.width && size_t(y) < m_maze.height
+            && !m_maze.is_wall({size_t(x), size_t(y)});
+    }
+
+    // Cell reached by a straight move with a forced neighboor: some cell next to it
+    // can only be reached optimally through it.
+    bool JumpPointSearch::is_straight_jump_point(ptrdiff_t x, ptrdiff_t y, Direction direction) const {
+        const auto [dx, dy] = direction;
+        if (m_corners_require_adjacent) {
+            // an obstacle ends next to the line of movement
+            if (dx != 0) {
+                return (is_free(x, y - 1) && !is_free(x - dx, y - 1))
+                    || (is_free(x, y + 1) && !is_free(x - dx, y + 1));
+            }
+            return (is_free(x - 1, y) && !is_free(x - 1, y - dy))
+                || (is_free(x + 1, y) && !is_free(x + 1, y - dy));
+        }
+        // an obstacle next to the line of movement hides a cell diagonally ahead
+        if (dx != 0) {
+            return (is_free(x + dx, y + 1) && !is_free(x, y + 1))
+                || (is_free(x + dx, y - 1) && !is_free(x, y - 1));
+        }
+        return (is_free(x + 1, y + dy) && !is_free(x + 1, y))
+            || (is_free(x - 1, y + dy) && !is_free(x - 1, y));
+    }
+
+    JumpPointSearch::Directions JumpPointSearch::pruned_directions(const Maze::Node& node, const Maze::Node* parent) const {
+        Directions result;
+        const auto x = ptrdiff_t(node.x);
+        const auto y = ptrdiff_t(node.y);
+        if (parent == nullptr) {
+            for (const auto& neighboor : m_maze.get_sides_and_corners(node, m_corners_require_adjacent)) {
+                result.push_back({sign(ptrdiff_t(neighboor.x) - x), sign(ptrdiff_t(neighboor.y) - y)});
+            }
+            return result;
+        }
+        const auto dx = sign(x - ptrdiff_t(parent->x));
+        const auto dy = sign(y - ptrdiff_t(parent->y));
+
+        if (m_corners_require_adjacent) {
+            if (dx != 0 && dy != 0) {
+                result.push_back({0, dy});
+                result.push_back({dx, 0});
+                result.push_back({dx, dy});
+                return result;
+            }
+            // perpendicular directions are natural here, because turning around a corner takes two moves
+            if (dx != 0) {
+                result.push_back({dx, 0});
+                result.push_back({dx, 1});
+                result.push_back({dx, -1});
+                result.push_back({0, 1});
+                result.push_back({0, -1});
+            } else {
+                result.push_back({0, dy});
+                result.push_back({1, dy});
+                result.push_back({-1, dy});
+                result.push_back({1, 0});
+                result.push_back({-1, 0});
+            }
+            return result;
+        }
+
+        if (dx != 0 && dy != 0) {
+            result.push_back({0, dy});
+            result.push_back({dx, 0});
+            result.push_back({dx, dy});
+            if (!is_free(x - dx, y)) {
+                result.push_back({-dx, dy});
+            }
+            if (!is_free(x, y - dy)) {
+                result.push_back({dx, -dy});
+            }
+        } else if (dx != 0) {
+            result.push_back({dx, 0});
+            if (!is_free(x, y + 1)) {
+                result.push_back({dx, 1});
+            }
+            if (!is_free(x, y - 1)) {
+                result.push_back({dx, -1});
+            }
+        } else {
+            result.push_back({0, dy});
+            if (!is_free(x + 1, y)) {
+                result.push_back({1, dy});
+            }
+            if (!is_free(x - 1, y)) {
+                result.push_back({-1, dy});
+            }
+        }
+        return result;
+    }
+
+    // first jump point after (x, y) in a straight direction
+    std::optional<Maze::Node> JumpPointSearch::jump_straight(ptrdiff_t x, ptrdiff_t y, Direction direction, const Maze::Node& goal) const {
+        const auto [dx, dy] = direction;
+        if (m_jump_distances_revision) {
+            const auto distance = m_jump_distances[util::coords_to_idx(size_t(x), size_t(y), m_maze.width)][straight_slot(dx, dy)];
+            const auto free_cells = std::abs(distance);
+            // goal is a jump point too, it may lie on the way
+            const auto goal_x = ptrdiff_t(goal.x);
+            const auto goal_y = ptrdiff_t(goal.y);
+            const auto goal_steps = dx != 0 ? (goal_x - x) * dx : (goal_y - y) * dy;
+            const bool goal_on_line = dx != 0 ? goal_y == y : goal_x == x;
+            if (goal_on_line && goal_steps > 0 && goal_steps <= free_cells) {
+                return goal;
+            }
+            if (distance <= 0) {
+                return std::nullopt;
+            }
+            return Maze::Node{size_t(x + dx * distance), size_t(y + dy * distance)};
+        }
+        while (true) {
+            x += dx;
+            y += dy;
+            if (!is_free(x, y)) {
+                return std::nullopt;
+            }
+            if ((Maze::Node{size_t(x), size_t(y)}) == goal || is_straight_jump_point(x, y, direction)) {
+                return Maze::Node{size_t(x), size_t(y)};
+            }
+        }
+    }
+
+    std::optional<Maze::Node> JumpPointSearch::jump(const Maze::Node& node, Direction direction, const Maze::Node& goal) const {
+        const auto [dx, dy] = direction;
+        auto x = ptrdiff_t(node.x);
+        auto y = ptrdiff_t(node.y);
+        if (dx == 0 || dy == 0) {
+            return jump_straight(x, y, direction, goal);
+        }
+        while (true) {
+            if (m_corners_require_adjacent && (!is_free(x + dx, y) || !is_free(x, y + dy))) {
+                return std::nullopt;
+            }
+            x += dx;
+            y += dy;
+            if (!is_free(x, y)) {
+                return std::nullopt;
+            }
+            const Maze::Node current{size_t(x), size_t(y)};
+            if (current == goal) {
+                return current;
+            }
+            if (!m_corners_require_adjacent
+                && ((is_free(x - dx, y + dy) && !is_free(x - dx, y))
+                    || (is_free(x + dx, y - dy) && !is_free(x, y - dy)))) {
+                return current;
+            }
+            // diagonal move stops where one of its straight components finds something
+            if (jump_straight(x, y, {dx, 0}, goal) || jump_straight(x, y, {0, dy}, goal)) {
+                return current;
+            }
+        }
+    }
+
+    JumpPointSearch::Successors JumpPointSearch::successors(const Maze::Node& node, const Maze::Node* parent, const Maze::Node& goal) const {
+        Successors result;
+        for (const auto& direction : pruned_directions(node, parent)) {
+            if (auto jump_point = jump(node, direction, goal)) {
+                result.push_back(*jump_point);
+            }
+        }
+        return result;
+    }
+
+    void JumpPointSearch::update_jump_distances() {
+        if (!m_precompute_jumps || m_jump_distances_revision == m_maze.revision) {
+            return;
+        }
+        const auto width = ptrdiff_t(m_maze.width);
+        const auto height = ptrdiff_t(m_maze.height);
+        m_jump_distances.assign(m_maze.cell_count(), {});
+        // each cell continues the value of its neighboor in the direction of the jump
+        auto update = [&](ptrdiff_t x, ptrdiff_t y, Direction direction) {
+            const auto [dx, dy] = direction;
+            const auto slot = straight_slot(dx, dy);
+            auto& distance = m_jump_distances[util::coords_to_idx(size_t(x), size_t(y), m_maze.width)][slot];
+            if (!is_free(x + dx, y + dy)) {
+                distance = 0;
+            } else if (is_straight_jump_point(x + dx, y + dy, direction)) {
+                distance = 1;
+            } else {
+                const auto next = m_jump_distances[util::coords_to_idx(size_t(x + dx), size_t(y + dy), m_maze.width)][slot];
+                distance = next > 0 ? next + 1 : next - 1;
+            }
+        };
+        for (ptrdiff_t y = 0; y < height; ++y) {
+            for (ptrdiff_t x = width - 1; x >= 0; --x) {
+                update(x, y, {1, 0});
+            }
+            for (ptrdiff_t x = 0; x < width; ++x) {
+                update(x, y, {-1, 0});
+            }
+        }
+        for (ptrdiff_t x = 0; x < width; ++x) {
+            for (ptrdiff_t y = height - 1; y >= 0; --y) {
+                update(x, y, {0, 1});
+            }
+            for (ptrdiff_t y = 0; y < height; ++y) {
+                update(x, y, {0, -1});
+            }
+        }
+        m_jump_distances_revision = m_maze.revision;
+    }
+
+    NodePath<Maze::Node> JumpPointSearch::connect_jump_points(const std::vector<Maze::Node>& jump_points) {
+        NodePath<Maze::Node> path = { jump_points.front() };
+        for (size_t i = 1; i < jump_points.size(); ++i) {
+            // consecutive jump points always lie on one straight or diagonal line
+            const auto dx = sign(ptrdiff_t(jump_points[i].x) - ptrdiff_t(path.back().x));
+            const auto dy = sign(ptrdiff_t(jump_points[i].y) - ptrdiff_t(path.back().y));
+            while (path.back() != jump_points[i]) {
+                const auto& last = path.back();
+                path.push_back({size_t(ptrdiff_t(last.x) + dx), size_t(ptrdiff_t(last.y) + dy)});
+            }
+        }
+        return path;
+    }
+}
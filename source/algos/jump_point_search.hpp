@@ -0,0 +1,131 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include <maze/maze.hpp>
+#include <util/static_vector.hpp>
+
+#include "search_algos_util.hpp"
+#include "search_observer.hpp"
+#include "indexed_heap.hpp"
+
+
+namespace algos {
+    // Jump Point Search (Harabor & Grastien) over Maze cells with side and corner moves.
+    // Moves cost 1 for sides and sqrt(2) for corners, slow tiles are treated as plain space,
+    // so it only finds shortest paths on uniform-cost mazes.
+    // `corners_require_adjacent` is the corner-cutting rule, same as in Maze::get_sides_and_corners.
+    //
+    // With `precompute_jumps` (JPS+) distances of straight jumps are cached for every cell.
+    // Straight jumps then take O(1) and diagonal ones O(1) per step. The cache is rebuilt
+    // when Maze::revision changes, so edits made through Maze are picked up automatically.
+    class JumpPointSearch {
+    public:
+        JumpPointSearch(const Maze& maze, bool corners_require_adjacent, bool precompute_jumps = false);
+
+        bool corners_require_adjacent() const {
+            return m_corners_require_adjacent;
+        }
+
+        // drops cached jump distances, needed only after writing `items` directly
+        void invalidate();
+
+        // Brings cached jump distances up to date now rather than on the next query.
+        // Until the maze changes, find_path then only reads this object and may run on several threads.
+        void update_jump_distances();
+
+        static double octile_distance(const Maze::Node& from, const Maze::Node& to);
+
+        // Path from `to` back to `from` through every cell, like reconstruct_path.
+        // `on_expand` is called for every jump point taken from the open list, `observer` sees jump points only as well.
+        template<typename OnExpand = EmptyUpdate<Maze::Node>, typename Observer = NullSearchObserver>
+        requires SearchObserver<Observer, Maze::Node>
+        NodePath<Maze::Node> find_path(
+                const Maze::Node& from,
+                const Maze::Node& to,
+                const OnExpand& on_expand = {},
+                const Observer& observer = {}
+        ) {
+            update_jump_distances();
+
+            struct Record {
+                Maze::Node node;
+                double distance;
+                size_t parent;
+                bool closed;
+            };
+            const auto indexer = m_maze.get_node_indexer();
+            DenseNodeSlots<Maze::Node, Maze::NodeIndexer> slots(indexer);
+            std::vector<Record> records = { {from, 0.0, 0, false} };
+            slots.insert(from, 0);
+            IndexedHeap<double> open;
+            open.push(0, octile_distance(from, to));
+            observer.discovered(from);
+            observer.pushed(from, open.size());
+
+            while (!open.empty()) {
+                const auto current_index = open.pop();
+                records[current_index].closed = true;
+                const auto current = records[current_index];
+                observer.popped(current.node, open.size());
+                observer.expanded(current.node);
+                on_expand(current.node);
+
+                if (current.node == to) {
+                    std::vector<Maze::Node> jump_points = { current.node };
+                    for (auto index = current_index; records[index].parent != index; index = records[index].parent) {
+                        jump_points.push_back(records[records[index].parent].node);
+                    }
+                    return connect_jump_points(jump_points);
+                }
+
+                const auto* parent = current_index == 0 ? nullptr : &records[current.parent].node;
+                for (const auto& jump_point : successors(current.node, parent, to)) {
+                    const auto distance = current.distance + octile_distance(current.node, jump_point);
+                    const auto index = slots.find(jump_point);
+                    if (index == npos) {
+                        slots.insert(jump_point, records.size());
+                        open.push(records.size(), distance + octile_distance(jump_point, to));
+                        records.push_back({jump_point, distance, current_index, false});
+                        observer.discovered(jump_point);
+                        observer.pushed(jump_point, open.size());
+                    } else if (!records[index].closed && distance < records[index].distance) {
+                        records[index].distance = distance;
+                        records[index].parent = current_index;
+                        open.decrease_key(index, distance + octile_distance(jump_point, to));
+                        observer.relaxed(current.node, jump_point);
+                    }
+                }
+            }
+            return {};
+        }
+
+    private:
+        struct Direction {
+            int dx;
+            int dy;
+        };
+        using Directions = util::StaticVector<Direction, 8>;
+        using Successors = util::StaticVector<Maze::Node, 8>;
+
+        const Maze& m_maze;
+        bool m_corners_require_adjacent;
+        bool m_precompute_jumps;
+        // Per cell, for +x, -x, +y, -y: steps to the next straight jump point if positive,
+        // otherwise minus the number of free cells before a wall or the border.
+        std::vector<std::array<int32_t, 4>> m_jump_distances;
+        std::optional<uint64_t> m_jump_distances_revision;
+
+        bool is_free(ptrdiff_t x, ptrdiff_t y) const;
+        bool is_straight_jump_point(ptrdiff_t x, ptrdiff_t y, Direction direction) const;
+        Directions pruned_directions(const Maze::Node& node, const Maze::Node* parent) const;
+        std::optional<Maze::Node> jump(const Maze::Node& node, Direction direction, const Maze::Node& goal) const;
+        std::optional<Maze::Node> jump_straight(ptrdiff_t x, ptrdiff_t y, Direction direction, const Maze::Node& goal) const;
+        Successors successors(const Maze::Node& node, const Maze::Node* parent, const Maze::Node& goal) const;
+
+        static NodePath<Maze::Node> connect_jump_points(const std::vector<Maze::Node>& jump_points);
+    };
+}
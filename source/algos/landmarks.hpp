@@ -0,0 +1,128 @@
+#pragma once
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+#include "dijkstra.hpp"
+#include "search_workspace.hpp"
+
+
+namespace algos {
+    // Preprocessing of ALT (A*, landmarks, triangle inequality).
+    // Path costs from and to a few landmark nodes are found once. For any two nodes and landmark L,
+    // cost(L, to) - cost(L, from) and cost(from, L) - cost(to, L) are then lower bounds of cost(from, to).
+    // Their maximum over all landmarks follows walls, which geometric estimates can not see.
+    //
+    // Landmarks are picked by farthest point selection among nodes reachable from `seed`: each one is the node
+    // farthest from those picked before, so they end up at the edges of the graph where bounds are the tightest.
+    // Costs to landmarks are found over reversed edges, so the neighboorhood has to be symmetric, weights may not be.
+    // Tables take 2 * count doubles per node, floats would round the bounds above the real costs.
+    template<typename Node, typename Indexer>
+    requires NodeIndexer<Indexer, Node>
+    class Landmarks {
+    public:
+        template<typename Neighboors, typename Weight>
+        requires NeighboorsGetter<Neighboors, Node> && WeightGetter<Weight, Node>
+        Landmarks(const Node& seed, const Neighboors& get_neighboors, const Weight& get_weight, const Indexer& indexer, size_t count)
+            : m_indexer(indexer)
+            , m_count(count)
+            , m_costs(2 * count * indexer.size(), infinity) {
+            SearchWorkspace<Node, Indexer> workspace(indexer);
+            auto reversed_weight = [&](const Node& from, const Node& to) {
+                return get_weight(to, from);
+            };
+            // cost to the closest landmark picked so far by slot, the seed stands in for the first one
+            auto closest = costs_from(seed, get_neighboors, get_weight, workspace);
+            std::vector<Node> reachable;
+            reachable.reserve(workspace.a_star.records.size());
+            for (const auto& record : workspace.a_star.records) {
+                reachable.push_back(record.node);
+            }
+            while (m_nodes.size() < m_count) {
+                const auto farthest = std::max_element(reachable.begin(), reachable.end(), [&](const Node& a, const Node& b) {
+                    return closest[m_indexer(a)] < closest[m_indexer(b)];
+                });
+                // every reachable node is a landmark already
+                if (farthest == reachable.end() || (!m_nodes.empty() && closest[m_indexer(*farthest)] == 0.0)) {
+                    break;
+                }
+                const auto landmark = *farthest;
+                const auto from_landmark = costs_from(landmark, get_neighboors, get_weight, workspace);
+                const auto to_landmark = costs_from(landmark, get_neighboors, reversed_weight, workspace);
+                const auto column = 2 * m_nodes.size();
+                for (size_t slot = 0; slot < from_landmark.size(); ++slot) {
+                    m_costs[slot * 2 * m_count + column] = from_landmark[slot];
+                    m_costs[slot * 2 * m_count + column + 1] = to_landmark[slot];
+                    closest[slot] = m_nodes.empty() ? from_landmark[slot] : std::min(closest[slot], from_landmark[slot]);
+                }
+                m_nodes.push_back(landmark);
+            }
+        }
+
+        // Lower bound of the cost from `from` to `to`
+        double estimate(const Node& from, const Node& to) const {
+            if (m_nodes.empty()) {
+                return 0.0;
+            }
+            const auto* from_costs = &m_costs[m_indexer(from) * 2 * m_count];
+            const auto* to_costs = &m_costs[m_indexer(to) * 2 * m_count];
+            double result = 0.0;
+            for (size_t column = 0; column < 2 * m_nodes.size(); column += 2) {
+                // a landmark that does not reach both nodes bounds nothing
+                if (from_costs[column] == infinity || to_costs[column] == infinity) {
+                    continue;
+                }
+                result = std::max({result, to_costs[column] - from_costs[column], from_costs[column + 1] - to_costs[column + 1]});
+            }
+            return result;
+        }
+
+        // HeuristicGetter towards `to`
+        struct Heuristic {
+            const Landmarks* landmarks;
+            Node to;
+
+            double operator()(const Node& node) const {
+                return landmarks->estimate(node, to);
+            }
+        };
+
+        Heuristic heuristic_to(const Node& to) const {
+            return {this, to};
+        }
+
+        // fewer than asked for if fewer nodes are reachable from the seed
+        const std::vector<Node>& nodes() const {
+            return m_nodes;
+        }
+
+    private:
+        static constexpr double infinity = std::numeric_limits<double>::infinity();
+
+        Indexer m_indexer;
+        size_t m_count;
+        std::vector<Node> m_nodes;
+        // by slot, then landmark: cost from the landmark, cost to it
+        std::vector<double> m_costs;
+
+        // Costs by slot of paths from `from`, found by Dijkstra over everything it reaches
+        template<typename Neighboors, typename Weight>
+        std::vector<double> costs_from(
+                const Node& from,
+                const Neighboors& get_neighboors,
+                const Weight& get_weight,
+                SearchWorkspace<Node, Indexer>& workspace
+        ) const {
+            auto never = [](const Node&) {
+                return false;
+            };
+            DijkstraFindPath(from, never, get_neighboors, get_weight, workspace);
+            std::vector<double> costs(m_indexer.size(), infinity);
+            for (const auto& record : workspace.a_star.records) {
+                costs[m_indexer(record.node)] = record.estimate;
+            }
+            return costs;
+        }
+    };
+}
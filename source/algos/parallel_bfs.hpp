@@ -0,0 +1,179 @@
+#pragma once
+
+#include <atomic>
+#include <concepts>
+#include <cstdint>
+#include <vector>
+
+#include <util/thread_pool.hpp>
+
+#include "search_algos_util.hpp"
+#include "search_observer.hpp"
+
+
+namespace algos {
+    namespace detail {
+        // switching thresholds from Beamer, Asanovic, Patterson, "Direction-Optimizing Breadth-First Search"
+        inline constexpr size_t bottom_up_alpha = 14;
+        inline constexpr size_t top_down_beta = 24;
+        inline constexpr size_t frontier_chunk = 256;
+        inline constexpr size_t slot_chunk = 4096;
+
+        inline void atomic_min(std::atomic<size_t>& target, size_t value) {
+            auto current = target.load(std::memory_order_relaxed);
+            while (value < current && !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+        }
+    }
+
+    // Level-synchronous breadth-first search on a thread pool, switching direction per level (Beamer et al.).
+    // Small levels are expanded top-down: frontier nodes claim undiscovered neighboors with a compare-exchange
+    // on their parent slot. Once the frontier is large compared to the undiscovered part of the graph,
+    // levels go bottom-up: every undiscovered node looks for a parent in a bitmap of the frontier,
+    // without contended writes and stopping at the first parent found.
+    //
+    // Finds a path with the fewest edges, like BFSFindPath, and hands the reconstructor its parent chain.
+    // When several nodes of one level are searched for, the one in the lowest slot is taken.
+    // Neighbourhoods must be symmetric. Slots that are not nodes of the graph (like maze walls) are allowed.
+    // `is_searched` and `get_neighboors` are called from several threads at once.
+    // `observer` is only called from the calling thread, which reports every level as a whole
+    // once workers are done with it, so it sees the same events a serial BFS would.
+    template<
+        std::equality_comparable Node,
+        typename Neighboors,
+        typename Predicate,
+        typename Indexer,
+        typename Reconstructor = decltype(reconstruct_path<Node>),
+        typename Observer = NullSearchObserver
+    >
+    requires NeighboorsGetter<Neighboors, Node>
+        && NodePredicate<Predicate, Node>
+        && ReversibleNodeIndexer<Indexer, Node>
+        && PathReconstructor<Reconstructor, Node>
+        && SearchObserver<Observer, Node>
+    static NodePath<Node> ParallelBFSFindPath(
+            const Node& from,
+            const Predicate& is_searched,
+            const Neighboors& get_neighboors,
+            const Indexer& indexer,
+            util::ThreadPool& pool,
+            const Reconstructor& reconstructor = reconstruct_path<Node>,
+            const Observer& observer = {}
+    ) {
+        constexpr bool is_observed = !std::same_as<Observer, NullSearchObserver>;
+        const size_t size = indexer.size();
+        // parent slot of every discovered node, the root is its own parent
+        std::vector<std::atomic<size_t>> parents(size);
+        pool.for_each_chunk(size, detail::slot_chunk, [&](size_t, size_t begin, size_t end) {
+            for (auto slot = begin; slot < end; ++slot) {
+                parents[slot].store(npos, std::memory_order_relaxed);
+            }
+        });
+        const size_t root = indexer(from);
+        parents[root].store(root, std::memory_order_relaxed);
+
+        std::vector<size_t> frontier = { root };
+        std::vector<uint64_t> frontier_bits;
+        std::vector<std::vector<size_t>> next_frontiers(pool.size());
+        size_t discovered = 1;
+        bool bottom_up = false;
+        observer.discovered(from);
+        observer.pushed(from, frontier.size());
+        while (!frontier.empty()) {
+            if constexpr (is_observed) {
+                for (size_t i = 0; i < frontier.size(); ++i) {
+                    const Node node = indexer.node(frontier[i]);
+                    observer.popped(node, frontier.size() - i - 1);
+                    observer.expanded(node);
+                }
+            }
+            std::atomic<size_t> found = npos;
+            pool.for_each_chunk(frontier.size(), detail::frontier_chunk, [&](size_t, size_t begin, size_t end) {
+                for (auto i = begin; i < end; ++i) {
+                    if (is_searched(indexer.node(frontier[i]))) {
+                        detail::atomic_min(found, frontier[i]);
+                    }
+                }
+            });
+            if (found != npos) {
+                std::vector<Node> chain;
+                for (auto slot = found.load(); ; slot = parents[slot].load(std::memory_order_relaxed)) {
+                    chain.push_back(indexer.node(slot));
+                    if (slot == root) {
+                        break;
+                    }
+                }
+                std::vector<ReconstructionItem<Node>> items;
+                items.reserve(chain.size());
+                for (size_t i = 0; i < chain.size(); ++i) {
+                    items.push_back({chain[chain.size() - 1 - i], i == 0 ? 0 : i - 1});
+                }
+                return reconstructor(chain.front(), items);
+            }
+
+            // node counts stand in for edge counts of the paper, degrees are bounded in grids
+            if (!bottom_up && frontier.size() * detail::bottom_up_alpha > size - discovered) {
+                bottom_up = true;
+            } else if (bottom_up && frontier.size() * detail::top_down_beta < size) {
+                bottom_up = false;
+            }
+
+            for (auto& next : next_frontiers) {
+                next.clear();
+            }
+            if (bottom_up) {
+                frontier_bits.assign((size + 63) / 64, 0);
+                for (const auto slot : frontier) {
+                    frontier_bits[slot / 64] |= uint64_t(1) << (slot % 64);
+                }
+                pool.for_each_chunk(size, detail::slot_chunk, [&](size_t worker, size_t begin, size_t end) {
+                    for (auto slot = begin; slot < end; ++slot) {
+                        if (parents[slot].load(std::memory_order_relaxed) != npos) {
+                            continue;
+                        }
+                        const Node node = indexer.node(slot);
+                        for (const Node& neighboor : get_neighboors(node)) {
+                            const size_t parent = indexer(neighboor);
+                            if ((frontier_bits[parent / 64] >> (parent % 64) & 1) == 0) {
+                                continue;
+                            }
+                            // slots outside of the graph see neighboors which do not see them back
+                            const auto around = get_neighboors(neighboor);
+                            if (rng::find(around, node) != rng::end(around)) {
+                                parents[slot].store(parent, std::memory_order_relaxed);
+                                next_frontiers[worker].push_back(slot);
+                            }
+                            break;
+                        }
+                    }
+                });
+            } else {
+                pool.for_each_chunk(frontier.size(), detail::frontier_chunk, [&](size_t worker, size_t begin, size_t end) {
+                    for (auto i = begin; i < end; ++i) {
+                        for (const Node& child : get_neighboors(indexer.node(frontier[i]))) {
+                            const size_t slot = indexer(child);
+                            auto expected = npos;
+                            if (parents[slot].load(std::memory_order_relaxed) == npos
+                                && parents[slot].compare_exchange_strong(expected, frontier[i], std::memory_order_relaxed)) {
+                                next_frontiers[worker].push_back(slot);
+                            }
+                        }
+                    }
+                });
+            }
+
+            frontier.clear();
+            for (const auto& next : next_frontiers) {
+                frontier.insert(frontier.end(), next.begin(), next.end());
+            }
+            if constexpr (is_observed) {
+                for (size_t i = 0; i < frontier.size(); ++i) {
+                    const Node node = indexer.node(frontier[i]);
+                    observer.discovered(node);
+                    observer.pushed(node, i + 1);
+                }
+            }
+            discovered += frontier.size();
+        }
+        return {};
+    }
+}
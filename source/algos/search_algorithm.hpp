@@ -0,0 +1,9 @@
+#pragma once
+
+
+namespace algos {
+    // Searches the apps and batch queries can run on a maze
+    enum class EAlgorithm {
+        BFS, DFS, RandomDFS, Dijkstra, Dial, AStar, JPS, BidirectionalBFS, BidirectionalAStar, HPAStar, DeltaStepping, DStarLite, ARAStar, BitboardBFS
+    };
+}
@@ -2,8 +2,11 @@
 
 #include <ranges>
 #include <algorithm>
+#include <chrono>
 #include <concepts>
+#include <cstdint>
 #include <vector>
+#include <limits>
 
 
 namespace algos {
@@ -37,6 +40,11 @@ namespace algos {
         { getter(node, node) } -> std::floating_point;
     };
 
+    template<typename T, typename Node>
+    concept IntegerWeightGetter = requires(T getter, Node node) {
+        { getter(node, node) } -> std::integral;
+    };
+
     template<typename Node>
     using NodePath = std::vector<Node>;
 
@@ -51,6 +59,160 @@ namespace algos {
         const size_t parent_index;
     };
 
+    template<typename T, typename Node>
+    concept PathReconstructor = requires(T reconstructor, Node node, const std::vector<ReconstructionItem<Node>>& parents) {
+        { reconstructor(node, parents) } -> std::convertible_to<NodePath<Node>>;
+    };
+
+    // Maps every node of a finite graph to a unique slot in [0, size()).
+    // Lets searches keep their bookkeeping in flat arrays instead of looking nodes up by equality.
+    template<typename T, typename Node>
+    concept NodeIndexer = requires(T indexer, Node node) {
+        { indexer(node) } -> std::convertible_to<size_t>;
+        { indexer.size() } -> std::convertible_to<size_t>;
+    };
+
+    // NodeIndexer that also gives back the node stored in a slot
+    template<typename T, typename Node>
+    concept ReversibleNodeIndexer = NodeIndexer<T, Node> && requires(T indexer, size_t slot) {
+        { indexer.node(slot) } -> std::convertible_to<Node>;
+    };
+
+    inline constexpr size_t npos = std::numeric_limits<size_t>::max();
+
+    // Work one call of a resumable search may do, it stops at whichever limit is reached first
+    struct SearchBudget {
+        double milliseconds = std::numeric_limits<double>::infinity();
+        size_t expansions = npos;
+    };
+
+    namespace detail {
+        // Counts expansions of one call against its SearchBudget
+        class BudgetTracker {
+            // reading the clock costs about as much as an expansion, so it is done once in a while
+            static constexpr size_t time_check_period = 16;
+
+            SearchBudget m_budget;
+            std::chrono::steady_clock::time_point m_start = std::chrono::steady_clock::now();
+            size_t m_expansions = 0;
+
+        public:
+            explicit BudgetTracker(const SearchBudget& budget)
+                : m_budget(budget) {}
+
+            // Called before every expansion, returns false once the budget is spent
+            bool take() {
+                if (m_expansions >= m_budget.expansions) {
+                    return false;
+                }
+                if (m_expansions % time_check_period == 0) {
+                    const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - m_start;
+                    if (elapsed.count() >= m_budget.milliseconds) {
+                        return false;
+                    }
+                }
+                ++m_expansions;
+                return true;
+            }
+        };
+    }
+
+    // Remembers the record index each discovered node was stored at.
+    // Fallback for nodes that can only be compared for equality: lookup is a linear scan.
+    template<typename Node>
+    class LinearNodeSlots {
+        std::vector<Node> m_nodes;
+
+    public:
+        size_t find(const Node& node) const {
+            auto it = rng::find(m_nodes, node);
+            return it == m_nodes.end() ? npos : size_t(it - m_nodes.begin());
+        }
+
+        // records are expected to be inserted in order: 0, 1, 2...
+        void insert(const Node& node, size_t) {
+            m_nodes.push_back(node);
+        }
+    };
+
+    // Same as LinearNodeSlots, but with O(1) lookup through a flat table addressed by a NodeIndexer
+    template<typename Node, typename Indexer>
+    requires NodeIndexer<Indexer, Node>
+    class DenseNodeSlots {
+        const Indexer& m_indexer;
+        std::vector<size_t> m_records;
+
+    public:
+        explicit DenseNodeSlots(const Indexer& indexer)
+            : m_indexer(indexer)
+            , m_records(indexer.size(), npos) {}
+
+        size_t find(const Node& node) const {
+            return m_records[m_indexer(node)];
+        }
+
+        void insert(const Node& node, size_t record) {
+            m_records[m_indexer(node)] = record;
+        }
+    };
+
+    // Same as DenseNodeSlots, but meant to be kept between searches. Entries are stamped with the search
+    // that wrote them, so `reset` only starts a new search and takes O(1) however many nodes were found
+    template<typename Node, typename Indexer>
+    requires NodeIndexer<Indexer, Node>
+    class ReusableNodeSlots {
+        struct Entry {
+            size_t record;
+            uint32_t generation;
+        };
+
+        Indexer m_indexer;
+        std::vector<Entry> m_entries;
+        uint32_t m_generation = 1;
+
+    public:
+        explicit ReusableNodeSlots(const Indexer& indexer)
+            : m_indexer(indexer)
+            , m_entries(indexer.size(), Entry{npos, 0}) {}
+
+        size_t find(const Node& node) const {
+            const auto& entry = m_entries[m_indexer(node)];
+            return entry.generation == m_generation ? entry.record : npos;
+        }
+
+        void insert(const Node& node, size_t record) {
+            m_entries[m_indexer(node)] = {record, m_generation};
+        }
+
+        void reset() {
+            // once the counter wraps around, entries of old searches would look current again
+            if (++m_generation == 0) {
+                rng::fill(m_entries, Entry{npos, 0});
+                m_generation = 1;
+            }
+        }
+    };
+
+    // Non-owning handle to slots, for searches which take theirs by value
+    template<typename Slots>
+    class SlotsRef {
+        Slots* m_slots;
+
+    public:
+        explicit SlotsRef(Slots& slots)
+            : m_slots(&slots) {}
+
+        template<typename Node>
+        size_t find(const Node& node) const {
+            return m_slots->find(node);
+        }
+
+        template<typename Node>
+        void insert(const Node& node, size_t record) {
+            m_slots->insert(node, record);
+        }
+    };
+
     template<typename Node>
     NodePath<Node> reconstruct_path(const Node& finish, const std::vector<ReconstructionItem<Node>>& parents) {
         NodePath<Node> result = {finish};
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+
+namespace algos {
+    // Events a search reports to its observer:
+    //  expanded(node) - node taken out of the open list and looked at
+    //  discovered(node) - node seen for the first time
+    //  pushed(node, open_size), popped(node, open_size) - open list changes, with its size after them
+    //  relaxed(from, to) - a cheaper way to an already discovered node was found
+    template<typename T, typename Node>
+    concept SearchObserver = requires(const T observer, const Node& node, size_t size) {
+        observer.expanded(node);
+        observer.discovered(node);
+        observer.pushed(node, size);
+        observer.popped(node, size);
+        observer.relaxed(node, node);
+    };
+
+    // Default observer of search templates, its calls compile to nothing
+    struct NullSearchObserver {
+        template<typename Node>
+        void expanded(const Node&) const noexcept {}
+
+        template<typename Node>
+        void discovered(const Node&) const noexcept {}
+
+        template<typename Node>
+        void pushed(const Node&, size_t) const noexcept {}
+
+        template<typename Node>
+        void popped(const Node&, size_t) const noexcept {}
+
+        template<typename Node>
+        void relaxed(const Node&, const Node&) const noexcept {}
+    };
+
+    struct SearchStats {
+        size_t expanded = 0;
+        size_t discovered = 0;
+        size_t pushes = 0;
+        size_t pops = 0;
+        size_t relaxations = 0;
+        size_t open_size = 0;
+        size_t peak_open_size = 0;
+        // open list size after every `sample_period` expansions
+        std::vector<float> open_size_samples;
+        size_t sample_period = 64;
+
+        size_t open_list_operations() const {
+            return pushes + pops + relaxations;
+        }
+    };
+
+    // Collects SearchStats, which it does not own. Copies write into the same stats
+    class StatsObserver {
+        SearchStats* m_stats;
+
+    public:
+        explicit StatsObserver(SearchStats& stats)
+            : m_stats(&stats) {}
+
+        template<typename Node>
+        void expanded(const Node&) const {
+            ++m_stats->expanded;
+            if (m_stats->expanded % m_stats->sample_period == 0) {
+                m_stats->open_size_samples.push_back(float(m_stats->open_size));
+            }
+        }
+
+        template<typename Node>
+        void discovered(const Node&) const {
+            ++m_stats->discovered;
+        }
+
+        template<typename Node>
+        void pushed(const Node&, size_t open_size) const {
+            ++m_stats->pushes;
+            m_stats->open_size = open_size;
+            m_stats->peak_open_size = std::max(m_stats->peak_open_size, open_size);
+        }
+
+        template<typename Node>
+        void popped(const Node&, size_t open_size) const {
+            ++m_stats->pops;
+            m_stats->open_size = open_size;
+        }
+
+        template<typename Node>
+        void relaxed(const Node&, const Node&) const {
+            ++m_stats->relaxations;
+        }
+    };
+}
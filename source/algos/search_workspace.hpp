@@ -0,0 +1,45 @@
+#pragma once
+
+#include <vector>
+
+#include "search_algos_util.hpp"
+#include "indexed_heap.hpp"
+
+
+namespace algos {
+    namespace detail {
+        template<typename Node>
+        struct AStarRecord {
+            Node node;
+            double estimate; // shortest path from start currently known
+            double heuristic; // computed once, when the node is discovered
+            size_t parent;
+        };
+
+        // Containers of an A* run. The search empties them when it starts, their capacity stays
+        template<typename Node>
+        struct AStarBuffers {
+            // after a search that found nothing, costs of every node it reached, which are then final
+            std::vector<AStarRecord<Node>> records;
+            // keyed by index in `records`, ordered by estimate + heuristic
+            IndexedHeap<double> open;
+            std::vector<ReconstructionItem<Node>> parents;
+        };
+    }
+
+    // Everything BFSFindPath, DijkstraFindPath and AStarFindPath need, kept between their runs.
+    // A search given a workspace starts by forgetting the previous one in O(1) and reuses its memory,
+    // so once the buffers have grown to the largest search, repeated queries do not allocate.
+    // Paths still come back as new vectors. A workspace serves one search at a time
+    template<typename Node, typename Indexer>
+    requires NodeIndexer<Indexer, Node>
+    struct SearchWorkspace {
+        ReusableNodeSlots<Node, Indexer> slots;
+        // BFS records, appended in discovery order, so they are its queue as well
+        std::vector<ReconstructionItem<Node>> parents;
+        detail::AStarBuffers<Node> a_star;
+
+        explicit SearchWorkspace(const Indexer& indexer)
+            : slots(indexer) {}
+    };
+}
@@ -0,0 +1,318 @@
+#pragma once
+
+#include <vector>
+
+#include "search_algos_util.hpp"
+#include "search_observer.hpp"
+#include "indexed_heap.hpp"
+
+
+// Searches that run in slices: every `step` call expands nodes until its budget is spent and keeps
+// the rest of the work for the next call. A caller can pull a few expansions per frame and draw them
+// as they happen, pause by not calling `step` and cancel by dropping the search.
+// They visit nodes in the same order as BFSFindPath, DFSFindPath and AStarFindPath with an indexer.
+namespace algos {
+    template<
+        std::equality_comparable Node,
+        typename Neighboors,
+        typename Predicate,
+        typename Indexer,
+        typename Observer = NullSearchObserver
+    >
+    requires NeighboorsGetter<Neighboors, Node>
+        && NodePredicate<Predicate, Node>
+        && NodeIndexer<Indexer, Node>
+        && SearchObserver<Observer, Node>
+    class StepwiseBFS {
+    public:
+        StepwiseBFS(const Node& from, Predicate is_searched, Neighboors get_neighboors, Indexer indexer, Observer observer = {})
+            : m_is_searched(std::move(is_searched))
+            , m_get_neighboors(std::move(get_neighboors))
+            , m_indexer(std::move(indexer))
+            , m_observer(std::move(observer))
+            , m_discovered(m_indexer.size(), false) {
+            m_discovered[m_indexer(from)] = true;
+            m_records.push_back({from, 0});
+            m_observer.discovered(from);
+            m_observer.pushed(from, size_t(1));
+        }
+
+        // Expands nodes until the budget runs out or the search is over, returns true once it is over.
+        // `on_expand` gets every expanded node before it is checked with the predicate
+        template<typename OnExpand = EmptyUpdate<Node>>
+        bool step(const SearchBudget& budget = {}, const OnExpand& on_expand = {}) {
+            detail::BudgetTracker tracker(budget);
+            // records are appended in discovery order, which is the order BFS expands them in
+            while (!m_finished && m_next < m_records.size() && tracker.take()) {
+                const auto current_index = m_next++;
+                const auto current = m_records[current_index].child;
+                m_observer.popped(current, m_records.size() - m_next);
+                m_observer.expanded(current);
+                on_expand(current);
+                if (m_is_searched(current)) {
+                    m_path = reconstruct_path(current, m_records);
+                    m_finished = true;
+                    break;
+                }
+                for (const Node& child : m_get_neighboors(current)) {
+                    const size_t slot = m_indexer(child);
+                    if (m_discovered[slot]) {
+                        continue;
+                    }
+                    m_discovered[slot] = true;
+                    m_records.push_back({child, current_index});
+                    m_observer.discovered(child);
+                    m_observer.pushed(child, m_records.size() - m_next);
+                }
+            }
+            m_finished = m_finished || m_next == m_records.size();
+            return m_finished;
+        }
+
+        bool is_finished() const {
+            return m_finished;
+        }
+
+        // from the found node back to `from`, empty until it is found or if there is none
+        const NodePath<Node>& path() const {
+            return m_path;
+        }
+
+        size_t expanded() const {
+            return m_next;
+        }
+
+    private:
+        Predicate m_is_searched;
+        Neighboors m_get_neighboors;
+        Indexer m_indexer;
+        Observer m_observer;
+        std::vector<bool> m_discovered;
+        std::vector<ReconstructionItem<Node>> m_records;
+        size_t m_next = 0;
+        bool m_finished = false;
+        NodePath<Node> m_path;
+    };
+
+    template<
+        std::equality_comparable Node,
+        typename Neighboors,
+        typename Predicate,
+        typename Indexer,
+        typename Observer = NullSearchObserver
+    >
+    requires NeighboorsGetter<Neighboors, Node>
+        && NodePredicate<Predicate, Node>
+        && NodeIndexer<Indexer, Node>
+        && SearchObserver<Observer, Node>
+    class StepwiseDFS {
+    public:
+        StepwiseDFS(const Node& from, Predicate is_searched, Neighboors get_neighboors, Indexer indexer, Observer observer = {})
+            : m_is_searched(std::move(is_searched))
+            , m_get_neighboors(std::move(get_neighboors))
+            , m_indexer(std::move(indexer))
+            , m_observer(std::move(observer))
+            , m_processed(m_indexer.size(), false) {
+            m_stack.push_back({from, 0});
+            m_observer.pushed(from, m_stack.size());
+        }
+
+        // Same contract as StepwiseBFS::step
+        template<typename OnExpand = EmptyUpdate<Node>>
+        bool step(const SearchBudget& budget = {}, const OnExpand& on_expand = {}) {
+            detail::BudgetTracker tracker(budget);
+            while (!m_finished && !m_stack.empty()) {
+                const auto [current, parent] = m_stack.back();
+                const size_t slot = m_indexer(current);
+                if (m_processed[slot]) {
+                    m_stack.pop_back();
+                    m_observer.popped(current, m_stack.size());
+                    continue;
+                }
+                if (!tracker.take()) {
+                    break;
+                }
+                m_stack.pop_back();
+                m_observer.popped(current, m_stack.size());
+                m_processed[slot] = true;
+                const auto my_index = m_records.size();
+                m_records.push_back({current, parent});
+                m_observer.discovered(current);
+                m_observer.expanded(current);
+                on_expand(current);
+                if (m_is_searched(current)) {
+                    m_path = reconstruct_path(current, m_records);
+                    m_finished = true;
+                    break;
+                }
+                for (const Node& child : m_get_neighboors(current)) {
+                    m_stack.push_back({child, my_index});
+                    m_observer.pushed(child, m_stack.size());
+                }
+            }
+            m_finished = m_finished || m_stack.empty();
+            return m_finished;
+        }
+
+        bool is_finished() const {
+            return m_finished;
+        }
+
+        // from the found node back to `from`, empty until it is found or if there is none
+        const NodePath<Node>& path() const {
+            return m_path;
+        }
+
+        size_t expanded() const {
+            return m_records.size();
+        }
+
+    private:
+        Predicate m_is_searched;
+        Neighboors m_get_neighboors;
+        Indexer m_indexer;
+        Observer m_observer;
+        std::vector<bool> m_processed;
+        // nodes waiting to be expanded with the record of the node they were reached from
+        std::vector<ReconstructionItem<Node>> m_stack;
+        std::vector<ReconstructionItem<Node>> m_records;
+        bool m_finished = false;
+        NodePath<Node> m_path;
+    };
+
+    // A* expanding nodes in slices of `step(budget, on_expand)`, runs Dijkstra's algorithm with ZeroHeuristic
+    template<
+        std::equality_comparable Node,
+        typename Neighboors,
+        typename Predicate,
+        typename Weight,
+        typename Heuristic,
+        typename Indexer,
+        typename Observer = NullSearchObserver
+    >
+    requires NeighboorsGetter<Neighboors, Node>
+        && NodePredicate<Predicate, Node>
+        && WeightGetter<Weight, Node>
+        && HeuristicGetter<Heuristic, Node>
+        && NodeIndexer<Indexer, Node>
+        && SearchObserver<Observer, Node>
+    class StepwiseAStar {
+    public:
+        StepwiseAStar(
+                const Node& from,
+                Predicate is_searched,
+                Neighboors get_neighboors,
+                Weight get_weight,
+                Heuristic get_heuristic,
+                Indexer indexer,
+                Observer observer = {}
+        )
+            : m_is_searched(std::move(is_searched))
+            , m_get_neighboors(std::move(get_neighboors))
+            , m_get_weight(std::move(get_weight))
+            , m_get_heuristic(std::move(get_heuristic))
+            , m_indexer(std::move(indexer))
+            , m_observer(std::move(observer))
+            , m_records_by_slot(m_indexer.size(), npos) {
+            m_records_by_slot[m_indexer(from)] = 0;
+            m_records.push_back({from, 0.0, double(m_get_heuristic(from)), 0});
+            m_open.push(0, m_records.front().heuristic);
+            m_observer.discovered(from);
+            m_observer.pushed(from, m_open.size());
+        }
+
+        // Same contract as StepwiseBFS::step
+        template<typename OnExpand = EmptyUpdate<Node>>
+        bool step(const SearchBudget& budget = {}, const OnExpand& on_expand = {}) {
+            detail::BudgetTracker tracker(budget);
+            while (!m_finished && !m_open.empty() && tracker.take()) {
+                const auto current_index = m_open.pop();
+                const auto current = m_records[current_index];
+                ++m_expanded;
+                m_observer.popped(current.node, m_open.size());
+                m_observer.expanded(current.node);
+                on_expand(current.node);
+                if (m_is_searched(current.node)) {
+                    publish_path(current_index);
+                    m_finished = true;
+                    break;
+                }
+                for (const auto& neighboor : m_get_neighboors(current.node)) {
+                    const auto edge_path_weight = current.estimate + double(m_get_weight(current.node, neighboor));
+                    const auto slot = m_indexer(neighboor);
+                    const auto index = m_records_by_slot[slot];
+                    if (index == npos) {
+                        const auto new_index = m_records.size();
+                        const auto heuristic = double(m_get_heuristic(neighboor));
+                        m_records_by_slot[slot] = new_index;
+                        m_records.push_back({neighboor, edge_path_weight, heuristic, current_index});
+                        m_open.push(new_index, edge_path_weight + heuristic);
+                        m_observer.discovered(neighboor);
+                        m_observer.pushed(neighboor, m_open.size());
+                        continue;
+                    }
+                    auto& existing = m_records[index];
+                    if (edge_path_weight < existing.estimate) {
+                        existing.estimate = edge_path_weight;
+                        existing.parent = current_index;
+                        m_observer.relaxed(current.node, neighboor);
+                        if (m_open.contains(index)) {
+                            m_open.decrease_key(index, edge_path_weight + existing.heuristic);
+                        }
+                    }
+                }
+            }
+            m_finished = m_finished || m_open.empty();
+            return m_finished;
+        }
+
+        bool is_finished() const {
+            return m_finished;
+        }
+
+        // from the found node back to `from`, empty until it is found or if there is none
+        const NodePath<Node>& path() const {
+            return m_path;
+        }
+
+        // of the found path
+        double path_cost() const {
+            return m_path_cost;
+        }
+
+        size_t expanded() const {
+            return m_expanded;
+        }
+
+    private:
+        struct Record {
+            Node node;
+            double estimate; // shortest path from start currently known
+            double heuristic; // computed once, when the node is discovered
+            size_t parent;
+        };
+
+        Predicate m_is_searched;
+        Neighboors m_get_neighboors;
+        Weight m_get_weight;
+        Heuristic m_get_heuristic;
+        Indexer m_indexer;
+        Observer m_observer;
+        std::vector<size_t> m_records_by_slot;
+        std::vector<Record> m_records;
+        // keyed by index in `m_records`, ordered by estimate + heuristic
+        IndexedHeap<double> m_open;
+        size_t m_expanded = 0;
+        bool m_finished = false;
+        NodePath<Node> m_path;
+        double m_path_cost = 0.0;
+
+        void publish_path(size_t index) {
+            m_path_cost = m_records[index].estimate;
+            m_path = { m_records[index].node };
+            for (; index != 0; index = m_records[index].parent) {
+                m_path.push_back(m_records[m_records[index].parent].node);
+            }
+        }
+    };
+}
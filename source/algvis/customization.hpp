@@ -1,22 +1,10 @@
 #include "parameters.hpp"
 #include <maze/maze.hpp>
+#include <maze/neighboorhood.hpp>
 
 
-using edge_getter_t = std::vector<Maze::Node> (*) (const Maze&, const Maze::Node&);
-
-edge_getter_t create_edge_getter(const ApplicationParams& params) {
-    if (!params.allow_diagonals) {
-        return [](const Maze& maze, const Maze::Node& node) {
-            return maze.get_cross_neighboors(node);
-        };
-    }
-    if (params.require_adjacent_for_diagonals) {
-        return [](const Maze& maze, const Maze::Node& node) {
-            return maze.get_sides_and_corners(node, true);
-        };
-    }
-    return [](const Maze& maze, const Maze::Node& node) {
-        return maze.get_sides_and_corners(node, false);
-    };
+// Calls `visitor` with the neighboorhood policy chosen by the parameters
+template<typename Visitor>
+decltype(auto) with_neighboorhood(const ApplicationParams& params, Visitor&& visitor) {
+    return neighboorhood::dispatch(params.allow_diagonals, params.require_adjacent_for_diagonals, std::forward<Visitor>(visitor));
 }
-
@@ -4,6 +4,17 @@
 #include "algos/DFS.hpp"
 #include "algos/dijkstra.hpp"
 #include "algos/a_star.hpp"
+#include "algos/ara_star.hpp"
+#include "algos/bidirectional.hpp"
+#include "algos/bitboard_bfs.hpp"
+#include "algos/jump_point_search.hpp"
+#include "algos/hpa_star.hpp"
+#include "algos/corridor_graph.hpp"
+#include "algos/delta_stepping.hpp"
+#include "algos/d_star_lite.hpp"
+#include "algos/landmarks.hpp"
+#include "algos/connected_components.hpp"
+#include "algos/batch_search.hpp"
 #include "visual/grid.hpp"
 
 #include <stdexcept>
@@ -14,6 +25,9 @@
 #include <util/random_utils.hpp>
 #include <thread>
 #include <chrono>
+#include <fstream>
+#include <optional>
+#include <sstream>
 
 namespace rng = std::ranges;
 
@@ -50,25 +64,129 @@ Maze create_maze(const ApplicationParams& params) {
     throw std::logic_error("Unknown maze generation algorithm!");
 }
 
-int main() {
+// Corner moves cost as much as side ones. JPS jumps are shortest for octile costs only,
+// so corners cost sqrt(2) when it is chosen, in the visual and the query mode alike
+double corner_move_cost(const ApplicationParams& params) {
+    return params.algorithm == ApplicationParams::EAlgorithm::JPS ? 1.4142135623730951 : 1.0;
+}
+
+// nodes plain A* expands for the same query with the same costs and estimate, to compare jump point search against
+template<typename Weight>
+size_t count_a_star_expansions(const Maze& maze, const Maze::Node& from, const Maze::Node& to, bool corners_require_adjacent, const Weight& get_weight) {
+    size_t expanded = 0;
+    neighboorhood::dispatch(true, corners_require_adjacent, [&](auto policy) {
+        algos::AStarFindPath(
+            from,
+            [&](const Maze::Node& node) {
+                ++expanded;
+                return node == to;
+            },
+            neighboorhood::Getter<decltype(policy)>{&maze},
+            get_weight,
+            [&](const Maze::Node& node) { return algos::JumpPointSearch::octile_distance(node, to); },
+            maze.get_node_indexer()
+        );
+    });
+    return expanded;
+}
+
+// one query per line: "from_x from_y to_x to_y", empty lines and lines starting with # are skipped
+std::vector<algos::PathQuery> load_queries(const std::filesystem::path& path) {
+    std::ifstream file(path);
+    if (!file) {
+        throw std::runtime_error("\"" + path.string() + "\": can not open file");
+    }
+    std::vector<algos::PathQuery> queries;
+    std::string line;
+    for (size_t line_number = 1; std::getline(file, line); ++line_number) {
+        if (line.find_first_not_of(" \t\r") == std::string::npos || line.front() == '#') {
+            continue;
+        }
+        std::istringstream fields(line);
+        algos::PathQuery query;
+        if (!(fields >> query.from.x >> query.from.y >> query.to.x >> query.to.y)) {
+            throw std::runtime_error("\"" + path.string() + "\": line " + std::to_string(line_number) + " is not a query");
+        }
+        queries.push_back(query);
+    }
+    return queries;
+}
+
+// `algvis <queries file>`: runs every query of the file on the configured maze and algorithm, without visualization.
+// Corner moves cost the same as in the visual mode, so both find paths of the same cost
+int run_queries_file(const ApplicationParams& params, const Maze& maze, const std::filesystem::path& path, util::ThreadPool& pool) {
+    const auto queries = load_queries(path);
+    const algos::BatchSearchSettings settings{
+        .algorithm = params.algorithm,
+        .allow_diagonals = params.allow_diagonals,
+        .corners_require_adjacent = params.require_adjacent_for_diagonals,
+        .corner_cost = corner_move_cost(params),
+        .slow_tile_cost = params.slow_tile_cost,
+        .bucket_width = params.bucket_width,
+        .seed = params.fixed_seed,
+    };
+    spdlog::info("running {} queries on {} threads", queries.size(), pool.size());
+    const auto start = std::chrono::steady_clock::now();
+    const auto results = algos::find_paths(maze, settings, queries, pool);
+    const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+    size_t found = 0;
+    size_t expanded = 0;
+    for (size_t i = 0; i < queries.size(); ++i) {
+        const auto& [from, to] = queries[i];
+        const auto& [path, stats] = results[i];
+        if (path.empty()) {
+            spdlog::info("{}, {} -> {}, {}: no way! Checked {} nodes", from.x, from.y, to.x, to.y, stats.expanded_nodes);
+        } else {
+            spdlog::info(
+                "{}, {} -> {}, {}: length {}, cost {:.2f}. Checked {} nodes in {:.3f} ms",
+                from.x, from.y, to.x, to.y, path.size(), stats.cost, stats.expanded_nodes, stats.milliseconds
+            );
+            ++found;
+        }
+        expanded += stats.expanded_nodes;
+    }
+    spdlog::info("{} of {} paths found, {} nodes checked, wall time taken(ms): {:.1f}", found, queries.size(), expanded, elapsed.count());
+    return 0;
+}
+
+int main(int argc, char** argv) {
     auto params = get_cached_application_params("config.json");
     spdlog::set_level(params.debug_level);
     set_random_seed(params.fixed_seed);
 
     Maze maze = create_maze(params);
+    maze.set_storage(params.maze_storage);
 
-    if (maze.from >= maze.items.size())
+    // shared by query mode and delta-stepping
+    util::ThreadPool pool;
+
+    if (argc > 2) {
+        spdlog::error("usage: {} [queries file]", argv[0]);
+        return 3;
+    }
+    if (argc == 2) {
+        return run_queries_file(params, maze, argv[1], pool);
+    }
+
+    if (maze.from >= maze.cell_count())
     {
         spdlog::error("Maze does not have a start!");
         return 1;
     }
 
-    if (maze.to >= maze.items.size())
+    if (maze.to >= maze.cell_count())
     {
         spdlog::error("Maze does not have a finish!");
         return 2;
     }
 
+    if (!maze.fits_compact_nodes())
+    {
+        spdlog::error("Maze sides are limited to {} cells to be shown", Maze::max_compact_side);
+        return 4;
+    }
+
     Maze::Node from {util::idx_to_coords(maze.from, maze.width)};
     Maze::Node to {util::idx_to_coords(maze.to, maze.width)};
     spdlog::info("searching path from {}, {} to {}, {}", from.x, from.y, to.x, to.y);
@@ -76,65 +194,187 @@ int main() {
         maze.save(params.save_file.value);
     }
 
-    std::vector<std::pair<Maze::Node, float>> estimates_log;
-    std::vector<Maze::Node> search_log;
-    std::vector<std::pair<Maze::Node, size_t>> discover_log;
-    auto edge_getter = create_edge_getter(params);
-    auto logging_edge_getter = [&](const Maze::Node& node) {
-        auto neighboors = edge_getter(maze, node);
-        rng::transform(neighboors, std::back_inserter(discover_log), [&](const Maze::Node& n) {
-            return std::pair{n, search_log.size()};
-        });
-        return neighboors;
-    };
-    auto random_logging_edge_getter = [&](const Maze::Node& node) {
-        auto neighboors = logging_edge_getter(node);
-        auto& rengine = get_rengine();
-        std::shuffle(neighboors.begin(), neighboors.end(), rengine);
-        return neighboors;
-    };
+    // logs keep compact nodes, they grow with every expansion
+    std::vector<std::pair<Maze::CompactNode, float>> estimates_log;
+    std::vector<Maze::CompactNode> search_log;
+    std::vector<std::pair<Maze::CompactNode, size_t>> discover_log;
     auto logging_searcher = [&](const Maze::Node& node) {
-        search_log.push_back(node);
+        search_log.emplace_back(node);
         return node == to;
     };
-    auto weight_getter = [&](const Maze::Node&, const Maze::Node& to) {
-        return maze.get_cell(to) == MazeObject::slow ? params.slow_tile_cost : 1.0;
+    const double corner_cost = corner_move_cost(params);
+    auto weight_getter = [&](const Maze::Node& from, const Maze::Node& to) {
+        const double distance = from.x != to.x && from.y != to.y ? corner_cost : 1.0;
+        return distance * (maze.get_cell(to) == MazeObject::slow ? params.slow_tile_cost : 1.0);
     };
 
+    // distance on an empty maze, matched to the neighboorhood. D* Lite estimates between any two cells
+    // and needs them consistent with weight_getter
+    auto cell_distance_estimate = [&](const Maze::Node& a, const Maze::Node& b) {
+        return std::min(params.slow_tile_cost.value, 1.0) * with_neighboorhood(params, [&](auto policy) {
+            return decltype(policy)::open_distance(a, b, corner_cost);
+        });
+    };
+    // built before the search when asked for, estimates of A* variants then follow walls.
+    // Landmarks lose to the geometric estimate in open areas far from all of them, both are lower bounds so the larger one is taken
+    std::optional<algos::Landmarks<Maze::Node, Maze::NodeIndexer>> landmarks;
     auto logging_estimate_getter = [&](const Maze::Node& node) {
-        auto dx = node.x - to.x;
-        auto dy = node.y - to.y;
-        auto estimate = std::sqrt(dx * dx + dy * dy);
-        estimates_log.push_back({node, estimate});
+        const auto estimate = landmarks
+            ? std::max(landmarks->estimate(node, to), cell_distance_estimate(node, to))
+            : cell_distance_estimate(node, to);
+        estimates_log.push_back({Maze::CompactNode(node), float(estimate)});
         return estimate;
     };
 
-    clock_t start = clock();
-    auto path = [&] {
-        using namespace algos;
-        switch (params.algorithm) {
-            case ApplicationParams::EAlgorithm::BFS: {
-                return BFSFindPath<Maze::Node>(from, logging_searcher, logging_edge_getter);
-            }
-            case ApplicationParams::EAlgorithm::DFS: {
-                return DFSFindPath<Maze::Node>(from, logging_searcher, logging_edge_getter);
-            }
-            case ApplicationParams::EAlgorithm::RandomDFS: {
-                return DFSFindPath<Maze::Node>(from, logging_searcher, random_logging_edge_getter);
-            }
-            case ApplicationParams::EAlgorithm::Dijkstra: {
-                return DijkstraFindPath(from, logging_searcher, logging_edge_getter, weight_getter);
-            }
-            case ApplicationParams::EAlgorithm::AStar: {
-                return AStarFindPath(from, logging_searcher, logging_edge_getter, weight_getter, logging_estimate_getter);
+    auto estimate_to_source_getter = [&](const Maze::Node& node) {
+        return landmarks
+            ? std::max(landmarks->estimate(from, node), cell_distance_estimate(from, node))
+            : cell_distance_estimate(from, node);
+    };
+    auto logging_expander = [&](const Maze::Node& node) {
+        search_log.emplace_back(node);
+    };
+
+    const bool use_jump_point_search = params.allow_diagonals && !maze.has_slow_tiles();
+    const bool searches_cells_directly = params.algorithm == ApplicationParams::EAlgorithm::JPS
+        || params.algorithm == ApplicationParams::EAlgorithm::HPAStar
+        || params.algorithm == ApplicationParams::EAlgorithm::DeltaStepping
+        || params.algorithm == ApplicationParams::EAlgorithm::DStarLite
+        || params.algorithm == ApplicationParams::EAlgorithm::BitboardBFS;
+    const bool uses_estimates = params.algorithm == ApplicationParams::EAlgorithm::AStar
+        || params.algorithm == ApplicationParams::EAlgorithm::JPS
+        || params.algorithm == ApplicationParams::EAlgorithm::BidirectionalAStar
+        || params.algorithm == ApplicationParams::EAlgorithm::HPAStar
+        || params.algorithm == ApplicationParams::EAlgorithm::ARAStar;
+    if (params.compress_corridors && searches_cells_directly) {
+        spdlog::warn("Jump point search, HPA*, delta-stepping, D* Lite and bitboard BFS work on maze cells, corridor compression is not used");
+    }
+    // neighboorhood is picked once, searches below are compiled for it
+    const auto path = with_neighboorhood(params, [&](auto policy) {
+        // one pass over the cells tells apart queries without a path, nothing is searched for them
+        algos::ConnectedComponents components(maze, params.allow_diagonals, params.require_adjacent_for_diagonals);
+        if (!components.connected(from, to)) {
+            spdlog::info("Start and finish are in different regions, nothing to search");
+            return algos::NodePath<Maze::Node>{};
+        }
+        const neighboorhood::Getter<decltype(policy)> grid_neighboors{&maze};
+        algos::CorridorGraph corridor_graph(maze, grid_neighboors, weight_getter);
+        const bool use_corridor_graph = params.compress_corridors && !searches_cells_directly;
+        const auto max_weight = use_corridor_graph ? corridor_graph.max_edge_weight() : std::max(params.slow_tile_cost.value, 1.0) * corner_cost;
+        if (params.landmarks > 0 && uses_estimates) {
+            const auto start = std::chrono::steady_clock::now();
+            landmarks.emplace(from, grid_neighboors, weight_getter, maze.get_node_indexer(), params.landmarks);
+            const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+            spdlog::info("Picked {} ALT landmarks in {:.1f} ms", landmarks->nodes().size(), elapsed.count());
+        }
+
+        // runs the chosen algorithm on maze cells or on the corridor graph, which have the same kind of getters
+        auto search = [&](const Maze::Node&, const Maze::Node&, const auto& get_neighboors, const auto& get_weight, const auto& indexer) {
+            auto logging_edge_getter = [&](const Maze::Node& node) {
+                auto neighboors = get_neighboors(node);
+                rng::transform(neighboors, std::back_inserter(discover_log), [&](const Maze::Node& n) {
+                    return std::pair{Maze::CompactNode(n), search_log.size()};
+                });
+                return neighboors;
+            };
+            auto random_logging_edge_getter = [&](const Maze::Node& node) {
+                auto neighboors = logging_edge_getter(node);
+                auto& rengine = get_rengine();
+                std::shuffle(neighboors.begin(), neighboors.end(), rengine);
+                return neighboors;
+            };
+
+            using namespace algos;
+            switch (params.algorithm) {
+                case ApplicationParams::EAlgorithm::BFS: {
+                    return BFSFindPath<Maze::Node>(from, logging_searcher, logging_edge_getter, indexer);
+                }
+                case ApplicationParams::EAlgorithm::DFS: {
+                    return DFSFindPath<Maze::Node>(from, logging_searcher, logging_edge_getter);
+                }
+                case ApplicationParams::EAlgorithm::RandomDFS: {
+                    return DFSFindPath<Maze::Node>(from, logging_searcher, random_logging_edge_getter);
+                }
+                case ApplicationParams::EAlgorithm::Dijkstra: {
+                    return DijkstraFindPath(from, logging_searcher, logging_edge_getter, get_weight, indexer);
+                }
+                case ApplicationParams::EAlgorithm::Dial: {
+                    // bucket queue needs integer weights, so costs are taken in fixed point with 2 decimal digits
+                    const FixedPointWeight fixed_weight{get_weight, 100.0};
+                    return DialFindPath(from, logging_searcher, logging_edge_getter, fixed_weight, fixed_weight.to_fixed(max_weight), indexer);
+                }
+                case ApplicationParams::EAlgorithm::AStar: {
+                    return AStarFindPath(from, logging_searcher, logging_edge_getter, get_weight, logging_estimate_getter, indexer);
+                }
+                case ApplicationParams::EAlgorithm::JPS: {
+                    if (!use_jump_point_search) {
+                        spdlog::warn("Jump point search needs diagonal moves and no slow tiles, running A* instead");
+                        return AStarFindPath(from, logging_searcher, logging_edge_getter, get_weight, logging_estimate_getter, indexer);
+                    }
+                    JumpPointSearch jump_point_search(maze, params.require_adjacent_for_diagonals);
+                    return jump_point_search.find_path(from, to, logging_expander);
+                }
+                case ApplicationParams::EAlgorithm::BidirectionalBFS: {
+                    return BidirectionalBFSFindPath(from, to, logging_edge_getter, indexer, reconstruct_path<Maze::Node>, logging_expander);
+                }
+                case ApplicationParams::EAlgorithm::BidirectionalAStar: {
+                    return BidirectionalAStarFindPath(
+                        from, to, logging_edge_getter, get_weight, logging_estimate_getter, estimate_to_source_getter,
+                        indexer, reconstruct_path<Maze::Node>, logging_expander
+                    );
+                }
+                case ApplicationParams::EAlgorithm::HPAStar: {
+                    HierarchicalPathfinder hpa(maze, grid_neighboors, weight_getter);
+                    const auto entrances = hpa.entrance_count();
+                    spdlog::info("HPA* abstraction has {} clusters and {} entrances", hpa.cluster_count(), entrances);
+                    return hpa.find_path(from, to, logging_estimate_getter, logging_expander);
+                }
+                case ApplicationParams::EAlgorithm::DeltaStepping: {
+                    const auto tree = DeltaSteppingShortestPaths(from, grid_neighboors, weight_getter, maze.get_node_indexer(), params.bucket_width.value, pool);
+                    // nodes are shown in the order a serial search would settle them
+                    const auto settled = tree.nodes_by_distance(tree.distance(to));
+                    rng::transform(settled, std::back_inserter(search_log), [](const Maze::Node& node) {
+                        return Maze::CompactNode(node);
+                    });
+                    return tree.path_to(to);
+                }
+                case ApplicationParams::EAlgorithm::DStarLite: {
+                    DStarLite d_star_lite(maze, grid_neighboors, weight_getter, cell_distance_estimate);
+                    return d_star_lite.find_path(from, to, logging_expander);
+                }
+                case ApplicationParams::EAlgorithm::ARAStar: {
+                    AnytimeRepairingAStar search(from, Equals<Maze::Node>{to}, logging_edge_getter, get_weight, logging_estimate_getter, indexer);
+                    while (!search.is_finished()) {
+                        if (search.improve({.expansions = 1024}, logging_expander)) {
+                            spdlog::info("ARA* found a path of cost {:.2f}, at most {:.2f} times the optimal one", search.path_cost(), search.suboptimality_bound());
+                        }
+                    }
+                    return search.path();
+                }
+                case ApplicationParams::EAlgorithm::BitboardBFS: {
+                    BitboardBFS bitboard_bfs(maze, params.allow_diagonals, params.require_adjacent_for_diagonals);
+                    return bitboard_bfs.find_path(from, to, logging_expander);
+                }
             }
+            // should not be reachable. Kept here for now because of gcc warning(end of non-void finction)
+            throw std::logic_error("Unknown algorithm!");
+        };
+
+        clock_t start = clock();
+        auto path = use_corridor_graph
+            ? corridor_graph.find_path(from, to, search)
+            : search(from, to, grid_neighboors, weight_getter, maze.get_node_indexer());
+        clock_t end = clock();
+        spdlog::info("Processor time taken(ms): {}", (double(end - start)) * 1000.0 / CLOCKS_PER_SEC);
+        if (use_corridor_graph) {
+            spdlog::info("Corridor graph has {} junctions and {} corridors", corridor_graph.junction_count(), corridor_graph.corridor_count());
         }
-        // should not be reachable. Kept here for now because of gcc warning(end of non-void finction)
-        throw std::logic_error("Unknown algorithm!");
-    }();
-    clock_t end = clock();
-    spdlog::info("Processor time taken(ms): {}", (double(end - start)) * 1000.0 / CLOCKS_PER_SEC);
+        return path;
+    });
     spdlog::info("Checked {} nodes", search_log.size());
+    if (params.algorithm == ApplicationParams::EAlgorithm::JPS && use_jump_point_search) {
+        spdlog::info("Plain A* checks {} nodes", count_a_star_expansions(maze, from, to, params.require_adjacent_for_diagonals, weight_getter));
+    }
 
     visual::initialize();
     auto display = al_create_display(params.display_width, params.display_height);
@@ -4,6 +4,7 @@
 #include <filesystem>
 #include <spdlog/common.h>
 #include <maze/maze_generation.hpp>
+#include <algos/search_algorithm.hpp>
 #include <util/parameter.hpp>
 
 
@@ -14,15 +15,17 @@ struct ApplicationParams {
     PARAMETER(int, display_width);
     PARAMETER(int, display_height);
 
-    enum class EAlgorithm {
-        BFS, DFS, RandomDFS, Dijkstra, AStar
-    };
+    using EAlgorithm = algos::EAlgorithm;
     PARAMETER(EAlgorithm, algorithm);
 
     PARAMETER(EMazeGenerationAlgorithm, generation_algorithm);
+    PARAMETER(EMazeStorage, maze_storage);
 
     PARAMETER(bool, allow_diagonals);
     PARAMETER(bool, require_adjacent_for_diagonals);
+    PARAMETER(bool, compress_corridors);
+    PARAMETER(double, bucket_width);
+    PARAMETER(size_t, landmarks);
 
     PARAMETER(double, wait_seconds);
     PARAMETER(double, desired_fps);
@@ -0,0 +1,822 @@
+#include <spdlog/spdlog.h>
+
+#include "algos/a_star.hpp"
+#include "algos/ara_star.hpp"
+#include "algos/hpa_star.hpp"
+#include "algos/corridor_graph.hpp"
+#include "algos/dijkstra.hpp"
+#include "algos/BFS.hpp"
+#include "algos/bitboard_bfs.hpp"
+#include "algos/csr_graph.hpp"
+#include "algos/parallel_bfs.hpp"
+#include "algos/delta_stepping.hpp"
+#include "algos/batch_search.hpp"
+#include "algos/distance_field.hpp"
+#include "algos/d_star_lite.hpp"
+#include "algos/jump_point_search.hpp"
+#include "algos/landmarks.hpp"
+
+#include <maze/maze_file.hpp>
+#include <maze/maze_generation.hpp>
+#include <maze/neighboorhood.hpp>
+#include <util/magic_enum_inc.h>
+#include <util/random_utils.hpp>
+#include <util/util.hpp>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Command line benchmark of search algorithms on generated mazes.
+// Usage: benchmark [maze size] [queries per maze]
+
+
+struct BenchmarkParams {
+    size_t maze_size = 1024;
+    size_t queries = 100;
+};
+
+struct Query {
+    Maze::Node from;
+    Maze::Node to;
+};
+
+class Stopwatch {
+    std::chrono::steady_clock::time_point m_start = std::chrono::steady_clock::now();
+
+public:
+    double elapsed_ms() const {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_start).count();
+    }
+};
+
+// random_dfs generation gets quadratic on big mazes, so it is benchmarked on a smaller one
+static constexpr size_t max_random_dfs_size = 256;
+
+Maze generate_maze(EMazeGenerationAlgorithm algorithm, size_t size) {
+    switch (algorithm) {
+        case EMazeGenerationAlgorithm::noise:
+            return generate_white_noise(size, size, 0.3);
+        case EMazeGenerationAlgorithm::random_dfs:
+            return generate_random_dfs(std::min(size, max_random_dfs_size), std::min(size, max_random_dfs_size));
+        case EMazeGenerationAlgorithm::binary_tree:
+            return generate_binary_tree(size, size);
+        case EMazeGenerationAlgorithm::sidewinder:
+            return generate_sidewinder(size, size);
+    }
+    throw std::logic_error("Unknown maze generation algorithm!");
+}
+
+std::vector<Query> random_queries(const Maze& maze, size_t count) {
+    auto& rengine = get_rengine();
+    std::uniform_int_distribution<size_t> x_distribution(0, maze.width - 1);
+    std::uniform_int_distribution<size_t> y_distribution(0, maze.height - 1);
+    auto random_free_cell = [&] {
+        while (true) {
+            const Maze::Node node{x_distribution(rengine), y_distribution(rengine)};
+            if (!maze.is_wall(node)) {
+                return node;
+            }
+        }
+    };
+    std::vector<Query> queries;
+    for (size_t i = 0; i < count; ++i) {
+        queries.push_back({random_free_cell(), random_free_cell()});
+    }
+    return queries;
+}
+
+double path_cost(const algos::NodePath<Maze::Node>& path, const auto& get_weight) {
+    double cost = 0.0;
+    // paths go from finish to start
+    for (size_t i = 1; i < path.size(); ++i) {
+        cost += get_weight(path[i], path[i - 1]);
+    }
+    return cost;
+}
+
+void benchmark_hpa(const BenchmarkParams& params) {
+    const size_t cluster_size = 32;
+    spdlog::info("HPA* (cluster size {}) against flat A*, {} queries per maze", cluster_size, params.queries);
+    for (const auto algorithm : magic_enum::enum_values<EMazeGenerationAlgorithm>()) {
+        const auto maze = generate_maze(algorithm, params.maze_size);
+        const auto queries = random_queries(maze, params.queries);
+        auto get_neighboors = [&](const Maze::Node& node) {
+            return maze.get_cross_neighboors(node);
+        };
+        auto get_weight = [](const Maze::Node&, const Maze::Node&) {
+            return 1.0;
+        };
+
+        Stopwatch build_time;
+        algos::HierarchicalPathfinder hpa(maze, get_neighboors, get_weight, cluster_size);
+        const auto entrances = hpa.entrance_count();
+        const auto build_ms = build_time.elapsed_ms();
+
+        double hpa_ms = 0.0;
+        double a_star_ms = 0.0;
+        double cost_ratio = 0.0;
+        size_t found = 0;
+        size_t mismatches = 0;
+        for (const auto& [from, to] : queries) {
+            auto manhattan = [to](const Maze::Node& node) {
+                return double(node.x > to.x ? node.x - to.x : to.x - node.x)
+                    + double(node.y > to.y ? node.y - to.y : to.y - node.y);
+            };
+            Stopwatch hpa_time;
+            const auto hpa_path = hpa.find_path(from, to, manhattan);
+            hpa_ms += hpa_time.elapsed_ms();
+
+            Stopwatch a_star_time;
+            const auto a_star_path = algos::AStarFindPath(from, algos::Equals<Maze::Node>{to}, get_neighboors, get_weight, manhattan, maze.get_node_indexer());
+            a_star_ms += a_star_time.elapsed_ms();
+
+            if (hpa_path.empty() != a_star_path.empty()) {
+                ++mismatches;
+            } else if (!a_star_path.empty() && a_star_path.size() > 1) {
+                ++found;
+                cost_ratio += path_cost(hpa_path, get_weight) / path_cost(a_star_path, get_weight);
+            }
+        }
+        spdlog::info(
+            "{:>12} {}x{}: build {:.1f} ms, {} entrances | per query: HPA* {:.3f} ms, A* {:.3f} ms | HPA* path {:.2f}% longer, {} connectivity mismatches",
+            magic_enum::enum_name(algorithm), maze.width, maze.height, build_ms, entrances,
+            hpa_ms / double(queries.size()), a_star_ms / double(queries.size()),
+            found == 0 ? 0.0 : (cost_ratio / double(found) - 1.0) * 100.0, mismatches
+        );
+    }
+}
+
+void benchmark_corridor_graph(const BenchmarkParams& params) {
+    spdlog::info("Dijkstra on the corridor graph against Dijkstra on cells, {} queries per maze", params.queries);
+    for (const auto algorithm : magic_enum::enum_values<EMazeGenerationAlgorithm>()) {
+        const auto maze = generate_maze(algorithm, params.maze_size);
+        const auto queries = random_queries(maze, params.queries);
+        auto get_neighboors = [&](const Maze::Node& node) {
+            return maze.get_cross_neighboors(node);
+        };
+        auto get_weight = [](const Maze::Node&, const Maze::Node&) {
+            return 1.0;
+        };
+
+        Stopwatch build_time;
+        algos::CorridorGraph graph(maze, get_neighboors, get_weight);
+        const auto junctions = graph.junction_count();
+        const auto build_ms = build_time.elapsed_ms();
+
+        double compressed_ms = 0.0;
+        double flat_ms = 0.0;
+        size_t compressed_expansions = 0;
+        size_t flat_expansions = 0;
+        size_t mismatches = 0;
+        for (const auto& [from, to] : queries) {
+            Stopwatch compressed_time;
+            const auto compressed_path = graph.find_path(from, to, [&](const auto&, const auto&, const auto& neighboors, const auto& weight, const auto& indexer) {
+                auto is_searched = [&](const Maze::Node& node) {
+                    ++compressed_expansions;
+                    return node == to;
+                };
+                return algos::DijkstraFindPath(from, is_searched, neighboors, weight, indexer);
+            });
+            compressed_ms += compressed_time.elapsed_ms();
+
+            Stopwatch flat_time;
+            auto is_searched = [&](const Maze::Node& node) {
+                ++flat_expansions;
+                return node == to;
+            };
+            const auto flat_path = algos::DijkstraFindPath(from, is_searched, get_neighboors, get_weight, maze.get_node_indexer());
+            flat_ms += flat_time.elapsed_ms();
+
+            if (path_cost(compressed_path, get_weight) != path_cost(flat_path, get_weight) || compressed_path.empty() != flat_path.empty()) {
+                ++mismatches;
+            }
+        }
+        spdlog::info(
+            "{:>12} {}x{}: build {:.1f} ms, {} junctions | per query: compressed {:.3f} ms, {} expansions, cells {:.3f} ms, {} expansions | {} cost mismatches",
+            magic_enum::enum_name(algorithm), maze.width, maze.height, build_ms, junctions,
+            compressed_ms / double(queries.size()), compressed_expansions / queries.size(),
+            flat_ms / double(queries.size()), flat_expansions / queries.size(), mismatches
+        );
+    }
+}
+
+// powers of two up to the number of hardware threads, and that number itself
+std::vector<size_t> thread_counts() {
+    std::vector<size_t> result;
+    const size_t max_threads = std::max(std::thread::hardware_concurrency(), 1u);
+    for (size_t threads = 1; threads < max_threads; threads *= 2) {
+        result.push_back(threads);
+    }
+    result.push_back(max_threads);
+    return result;
+}
+
+void benchmark_parallel_bfs(const BenchmarkParams& params) {
+    spdlog::info("Parallel BFS over the whole maze against BFSFindPath, 1 to {} threads", thread_counts().back());
+    for (const auto algorithm : magic_enum::enum_values<EMazeGenerationAlgorithm>()) {
+        const auto maze = generate_maze(algorithm, params.maze_size);
+        const auto from = random_queries(maze, 1).front().from;
+        auto get_neighboors = [&](const Maze::Node& node) {
+            return maze.get_cross_neighboors(node);
+        };
+        auto never = [](const Maze::Node&) {
+            return false;
+        };
+
+        Stopwatch serial_time;
+        algos::BFSFindPath(from, never, get_neighboors, maze.get_node_indexer());
+        spdlog::info("{:>12} {}x{}: BFSFindPath {:.1f} ms", magic_enum::enum_name(algorithm), maze.width, maze.height, serial_time.elapsed_ms());
+        for (const auto threads : thread_counts()) {
+            util::ThreadPool pool(threads);
+            Stopwatch parallel_time;
+            algos::ParallelBFSFindPath(from, never, get_neighboors, maze.get_node_indexer(), pool);
+            spdlog::info("{:>12} {} threads: {:.1f} ms", "", threads, parallel_time.elapsed_ms());
+        }
+    }
+}
+
+void benchmark_bitboard_bfs(const BenchmarkParams& params) {
+    spdlog::info("Bitboard BFS against BFSFindPath, {} queries per maze", params.queries);
+    for (const auto algorithm : magic_enum::enum_values<EMazeGenerationAlgorithm>()) {
+        const auto maze = generate_maze(algorithm, params.maze_size);
+        const auto queries = random_queries(maze, params.queries);
+        for (const auto& [allow_diagonals, corners_require_adjacent] : {std::pair{false, true}, std::pair{true, true}, std::pair{true, false}}) {
+            auto get_neighboors = [&](const Maze::Node& node) {
+                return allow_diagonals ? maze.get_sides_and_corners(node, corners_require_adjacent) : maze.get_cross_neighboors(node);
+            };
+            Stopwatch queue_time;
+            for (const auto& query : queries) {
+                algos::BFSFindPath(query.from, algos::Equals<Maze::Node>{query.to}, get_neighboors, maze.get_node_indexer());
+            }
+            const auto queue_ms = queue_time.elapsed_ms();
+
+            algos::BitboardBFS bitboard_bfs(maze, allow_diagonals, corners_require_adjacent);
+            bitboard_bfs.update_cells();
+            Stopwatch bitboard_time;
+            for (const auto& query : queries) {
+                bitboard_bfs.find_path(query.from, query.to);
+            }
+            const auto neighbourhood = !allow_diagonals ? "sides" : corners_require_adjacent ? "strict corners" : "corners";
+            spdlog::info("{:>12} {}x{}, {:>14}: BFSFindPath {:.1f} ms, bitboard {:.1f} ms",
+                magic_enum::enum_name(algorithm), maze.width, maze.height, neighbourhood, queue_ms, bitboard_time.elapsed_ms());
+        }
+    }
+}
+
+void benchmark_delta_stepping(const BenchmarkParams& params) {
+    const double slow_tile_cost = 5.0;
+    spdlog::info("Delta-stepping against DijkstraFindPath over the whole noise maze, slow tiles cost {}", slow_tile_cost);
+    for (const auto slow_tile_chance : {0.0, 0.1, 0.3, 0.5}) {
+        auto maze = generate_maze(EMazeGenerationAlgorithm::noise, params.maze_size);
+        maze.add_slow_tiles(slow_tile_chance);
+        const auto from = random_queries(maze, 1).front().from;
+        auto get_neighboors = [&](const Maze::Node& node) {
+            return maze.get_cross_neighboors(node);
+        };
+        auto get_weight = [&](const Maze::Node&, const Maze::Node& to) {
+            return maze.get_cell(to) == MazeObject::slow ? slow_tile_cost : 1.0;
+        };
+        auto never = [](const Maze::Node&) {
+            return false;
+        };
+
+        Stopwatch serial_time;
+        algos::DijkstraFindPath(from, never, get_neighboors, get_weight, maze.get_node_indexer());
+        spdlog::info("slow tile chance {:.1f}: DijkstraFindPath {:.1f} ms", slow_tile_chance, serial_time.elapsed_ms());
+        for (const auto bucket_width : {1.0, slow_tile_cost}) {
+            for (const auto threads : thread_counts()) {
+                util::ThreadPool pool(threads);
+                Stopwatch parallel_time;
+                algos::DeltaSteppingShortestPaths(from, get_neighboors, get_weight, maze.get_node_indexer(), bucket_width, pool);
+                spdlog::info("{:>22} width {:.0f}, {} threads: {:.1f} ms", "", bucket_width, threads, parallel_time.elapsed_ms());
+            }
+        }
+    }
+}
+
+// queries with the goal at most `radius` cells away on both axes, where clearing per query tables dominates
+std::vector<Query> nearby_queries(const Maze& maze, size_t count, size_t radius) {
+    auto& rengine = get_rengine();
+    std::uniform_int_distribution<size_t> offset_distribution(0, 2 * radius);
+    auto queries = random_queries(maze, count);
+    for (auto& [from, to] : queries) {
+        do {
+            to.x = std::clamp(from.x + offset_distribution(rengine), radius, maze.width - 1 + radius) - radius;
+            to.y = std::clamp(from.y + offset_distribution(rengine), radius, maze.height - 1 + radius) - radius;
+        } while (maze.is_wall(to));
+    }
+    return queries;
+}
+
+void benchmark_batch_search(const BenchmarkParams& params) {
+    const size_t radius = 16;
+    spdlog::info("Batch A* against AStarFindPath called per query, {} queries on the noise maze", params.queries);
+    const auto maze = generate_maze(EMazeGenerationAlgorithm::noise, params.maze_size);
+    auto get_neighboors = [&](const Maze::Node& node) {
+        return maze.get_sides_and_corners(node, true);
+    };
+    const algos::BatchSearchSettings settings{.algorithm = algos::EAlgorithm::AStar, .allow_diagonals = true};
+    // same weights as the batch uses
+    auto get_weight = [&](const Maze::Node& from, const Maze::Node& to) {
+        const double distance = from.x != to.x && from.y != to.y ? 1.4142135623730951 : 1.0;
+        return distance * (maze.get_cell(to) == MazeObject::slow ? settings.slow_tile_cost : 1.0);
+    };
+
+    for (const auto& [name, queries] : {
+        std::pair{"random", random_queries(maze, params.queries)},
+        std::pair{"nearby", nearby_queries(maze, params.queries, radius)}
+    }) {
+        Stopwatch serial_time;
+        for (const auto& [from, to] : queries) {
+            auto heuristic = [&](const Maze::Node& node) {
+                const auto dx = double(node.x) - double(to.x);
+                const auto dy = double(node.y) - double(to.y);
+                return std::sqrt(dx * dx + dy * dy);
+            };
+            algos::AStarFindPath(from, algos::Equals<Maze::Node>{to}, get_neighboors, get_weight, heuristic, maze.get_node_indexer());
+        }
+        spdlog::info("{} queries: AStarFindPath {:.1f} ms", name, serial_time.elapsed_ms());
+
+        std::vector<algos::PathQuery> batch;
+        for (const auto& [from, to] : queries) {
+            batch.push_back({from, to});
+        }
+        for (const auto threads : thread_counts()) {
+            util::ThreadPool pool(threads);
+            Stopwatch batch_time;
+            algos::find_paths(maze, settings, batch, pool);
+            spdlog::info("{:>15} batch, {} threads: {:.1f} ms", "", threads, batch_time.elapsed_ms());
+        }
+    }
+}
+
+void benchmark_distance_field(const BenchmarkParams& params) {
+    const size_t brush_size = 3;
+    spdlog::info("Distance field to the finish against A* per start, {} starts, then {} {}x{} wall brushes", params.queries, params.queries, brush_size, brush_size);
+    auto maze = generate_maze(EMazeGenerationAlgorithm::noise, params.maze_size);
+    const auto queries = random_queries(maze, params.queries);
+    const Maze::Node to = queries.front().to;
+    maze.to = util::coords_to_idx(to.x, to.y, maze.width);
+    auto get_neighboors = [&](const Maze::Node& node) {
+        return maze.get_sides_and_corners(node, true);
+    };
+    auto get_weight = [](const Maze::Node& from, const Maze::Node& to) {
+        return from.x != to.x && from.y != to.y ? 1.4142135623730951 : 1.0;
+    };
+    auto heuristic = [&](const Maze::Node& node) {
+        return algos::JumpPointSearch::octile_distance(node, to);
+    };
+
+    Stopwatch a_star_time;
+    for (const auto& query : queries) {
+        algos::AStarFindPath(query.from, algos::Equals<Maze::Node>{to}, get_neighboors, get_weight, heuristic, maze.get_node_indexer());
+    }
+    spdlog::info("AStarFindPath: {:.1f} ms", a_star_time.elapsed_ms());
+
+    algos::DistanceField field(maze, get_neighboors, get_weight);
+    Stopwatch build_time;
+    field.update();
+    const auto build_ms = build_time.elapsed_ms();
+    Stopwatch read_time;
+    for (const auto& query : queries) {
+        field.path_from(query.from);
+    }
+    spdlog::info("field: built in {:.1f} ms, paths read in {:.1f} ms", build_ms, read_time.elapsed_ms());
+
+    Stopwatch repair_time;
+    for (const auto& query : random_queries(maze, params.queries)) {
+        const auto revision = maze.revision;
+        std::vector<Maze::Node> changed;
+        for (auto y = query.from.y; y < std::min(query.from.y + brush_size, maze.height); ++y) {
+            for (auto x = query.from.x; x < std::min(query.from.x + brush_size, maze.width); ++x) {
+                if (Maze::Node{x, y} != to && !maze.is_wall({x, y})) {
+                    maze.get_cell({x, y}) = MazeObject::wall;
+                    changed.push_back({x, y});
+                }
+            }
+        }
+        field.cells_changed(changed, revision);
+        field.update();
+    }
+    spdlog::info("field: {} repairs in {:.1f} ms, a rebuild takes {:.1f} ms", params.queries, repair_time.elapsed_ms(), build_ms);
+}
+
+void benchmark_d_star_lite(const BenchmarkParams& params) {
+    const size_t brush_size = 3;
+    spdlog::info("D* Lite repairs against A* replanning, an agent walks to its goal and a {}x{} wall brush lands after every step", brush_size, brush_size);
+    auto maze = generate_maze(EMazeGenerationAlgorithm::noise, params.maze_size);
+    auto get_neighboors = [&](const Maze::Node& node) {
+        return maze.get_sides_and_corners(node, true);
+    };
+    auto get_weight = [](const Maze::Node& from, const Maze::Node& to) {
+        return from.x != to.x && from.y != to.y ? 1.4142135623730951 : 1.0;
+    };
+    auto distance = [](const Maze::Node& from, const Maze::Node& to) {
+        return algos::JumpPointSearch::octile_distance(from, to);
+    };
+    algos::DStarLite d_star_lite(maze, get_neighboors, get_weight, distance);
+
+    // a pair far enough apart for the walk to take a while
+    auto query = random_queries(maze, 1).front();
+    while (d_star_lite.find_path(query.from, query.to).size() < params.maze_size / 2) {
+        query = random_queries(maze, 1).front();
+    }
+    auto agent = query.from;
+    const auto to = query.to;
+
+    double d_star_lite_ms = 0.0;
+    double a_star_ms = 0.0;
+    size_t d_star_lite_expanded = 0;
+    size_t a_star_expanded = 0;
+    size_t steps = 0;
+    for (const auto& brush : random_queries(maze, params.queries)) {
+        const auto revision = maze.revision;
+        std::vector<Maze::Node> changed;
+        for (auto y = brush.from.y; y < std::min(brush.from.y + brush_size, maze.height); ++y) {
+            for (auto x = brush.from.x; x < std::min(brush.from.x + brush_size, maze.width); ++x) {
+                if (Maze::Node{x, y} != to && Maze::Node{x, y} != agent && !maze.is_wall({x, y})) {
+                    maze.get_cell({x, y}) = MazeObject::wall;
+                    changed.push_back({x, y});
+                }
+            }
+        }
+        d_star_lite.cells_changed(changed, revision);
+
+        Stopwatch d_star_lite_time;
+        const auto path = d_star_lite.find_path(agent, to, [&](const Maze::Node&) {
+            ++d_star_lite_expanded;
+        });
+        d_star_lite_ms += d_star_lite_time.elapsed_ms();
+
+        auto counting_searcher = [&](const Maze::Node& node) {
+            ++a_star_expanded;
+            return node == to;
+        };
+        auto heuristic = [&](const Maze::Node& node) {
+            return distance(node, to);
+        };
+        Stopwatch a_star_time;
+        algos::AStarFindPath(agent, counting_searcher, get_neighboors, get_weight, heuristic, maze.get_node_indexer());
+        a_star_ms += a_star_time.elapsed_ms();
+
+        if (path.size() < 2) {
+            break;
+        }
+        agent = path[path.size() - 2];
+        ++steps;
+    }
+    spdlog::info("{} steps, AStarFindPath: {:.1f} ms, {} nodes expanded", steps, a_star_ms, a_star_expanded);
+    spdlog::info("{} steps, D* Lite: {:.1f} ms, {} nodes expanded", steps, d_star_lite_ms, d_star_lite_expanded);
+}
+
+void benchmark_ara_star(const BenchmarkParams& params) {
+    spdlog::info("ARA* first and final paths against A*, {} queries on the noise maze", params.queries);
+    const auto maze = generate_maze(EMazeGenerationAlgorithm::noise, params.maze_size);
+    const auto queries = random_queries(maze, params.queries);
+    auto get_neighboors = [&](const Maze::Node& node) {
+        return maze.get_sides_and_corners(node, true);
+    };
+    auto get_weight = [](const Maze::Node& from, const Maze::Node& to) {
+        return from.x != to.x && from.y != to.y ? 1.4142135623730951 : 1.0;
+    };
+
+    Stopwatch a_star_time;
+    double optimal_cost = 0.0;
+    for (const auto& query : queries) {
+        auto heuristic = [&](const Maze::Node& node) {
+            return algos::JumpPointSearch::octile_distance(node, query.to);
+        };
+        const auto path = algos::AStarFindPath(query.from, algos::Equals<Maze::Node>{query.to}, get_neighboors, get_weight, heuristic, maze.get_node_indexer());
+        optimal_cost += path_cost(path, get_weight);
+    }
+    spdlog::info("AStarFindPath: {:.1f} ms, total cost {:.1f}", a_star_time.elapsed_ms(), optimal_cost);
+
+    double first_ms = 0.0;
+    double first_cost = 0.0;
+    double final_ms = 0.0;
+    for (const auto& query : queries) {
+        auto heuristic = [&](const Maze::Node& node) {
+            return algos::JumpPointSearch::octile_distance(node, query.to);
+        };
+        Stopwatch time;
+        algos::AnytimeRepairingAStar search(query.from, algos::Equals<Maze::Node>{query.to}, get_neighboors, get_weight, heuristic, maze.get_node_indexer());
+        // small slices, like frames of an app waiting for its first path
+        while (!search.is_finished() && search.path().empty()) {
+            search.improve({.expansions = 256});
+        }
+        first_ms += time.elapsed_ms();
+        if (!search.path().empty()) {
+            first_cost += search.path_cost();
+        }
+        search.improve();
+        final_ms += time.elapsed_ms();
+    }
+    spdlog::info("ARA*: first paths in {:.1f} ms with total cost {:.1f}, optimal ones in {:.1f} ms", first_ms, first_cost, final_ms);
+}
+
+void benchmark_neighboorhood_policies(const BenchmarkParams& params) {
+    constexpr size_t passes = 10;
+    spdlog::info("Neighboorhood policies against a function pointer getter, {} passes over every cell", passes);
+    using EdgeGetter = Maze::NeighboorList (*) (const Maze&, const Maze::Node&);
+    const auto maze = generate_maze(EMazeGenerationAlgorithm::noise, params.maze_size);
+    // only getters are timed, a search would add its own bookkeeping on top
+    auto run = [&](const auto& get_neighboors) {
+        Stopwatch time;
+        size_t found = 0;
+        for (size_t pass = 0; pass < passes; ++pass) {
+            for (size_t y = 0; y < maze.height; ++y) {
+                for (size_t x = 0; x < maze.width; ++x) {
+                    found += get_neighboors(Maze::Node{x, y}).size();
+                }
+            }
+        }
+        return std::pair{time.elapsed_ms(), found};
+    };
+    auto compare = [&](const char* name, auto policy) {
+        using Policy = decltype(policy);
+        // picked at runtime like the apps used to, so the compiler sees only a pointer
+        volatile EdgeGetter edge_getter = [](const Maze& maze, const Maze::Node& node) {
+            return Policy::allows_diagonals
+                ? maze.get_sides_and_corners(node, Policy::corners_require_adjacent)
+                : maze.get_cross_neighboors(node);
+        };
+        const auto [pointer_ms, pointer_found] = run([&](const Maze::Node& node) {
+            return edge_getter(maze, node);
+        });
+        const auto [policy_ms, policy_found] = run(neighboorhood::Getter<Policy>{&maze});
+        if (pointer_found != policy_found) {
+            spdlog::error("{} policy found {} neighboors instead of {}", name, policy_found, pointer_found);
+        }
+        spdlog::info("{:>12}: function pointer {:.1f} ms, policy {:.1f} ms", name, pointer_ms, policy_ms);
+    };
+    compare("Cross4", neighboorhood::Cross4{});
+    compare("Diag8Strict", neighboorhood::Diag8Strict{});
+    compare("Diag8Loose", neighboorhood::Diag8Loose{});
+}
+
+void benchmark_compact_nodes(const BenchmarkParams& params) {
+    const auto maze = generate_maze(EMazeGenerationAlgorithm::noise, params.maze_size);
+    if (!maze.fits_compact_nodes()) {
+        spdlog::info("Maze is too big for compact nodes");
+        return;
+    }
+    spdlog::info("{} byte nodes against {} byte compact ones, {} queries", sizeof(Maze::Node), sizeof(Maze::CompactNode), params.queries);
+    const auto queries = random_queries(maze, params.queries);
+    const auto get_weight = [&](const Maze::Node&, const Maze::Node& to) {
+        return maze.get_cell(to) == MazeObject::slow ? 2.0 : 1.0;
+    };
+    // `find_path` gets a query with nodes of the kind it searches, its paths are summed up to compare them
+    auto run = [&](const auto& find_path) {
+        Stopwatch time;
+        double cost = 0.0;
+        for (const auto& query : queries) {
+            const auto path = find_path(query);
+            cost += path_cost(algos::NodePath<Maze::Node>(path.begin(), path.end()), get_weight);
+        }
+        return std::pair{time.elapsed_ms(), cost};
+    };
+    auto compare = [&](const char* name, const auto& find_path) {
+        const auto [wide_ms, wide_cost] = run([&](const Query& query) {
+            return find_path(query.from, query.to, neighboorhood::Getter<neighboorhood::Cross4>{&maze}, maze.get_node_indexer());
+        });
+        const auto [compact_ms, compact_cost] = run([&](const Query& query) {
+            return find_path(
+                Maze::CompactNode(query.from), Maze::CompactNode(query.to),
+                neighboorhood::CompactGetter<neighboorhood::Cross4>{&maze}, maze.get_compact_node_indexer()
+            );
+        });
+        if (std::abs(wide_cost - compact_cost) > 1e-6) {
+            spdlog::error("{} over compact nodes found paths of total cost {:.1f} instead of {:.1f}", name, compact_cost, wide_cost);
+        }
+        spdlog::info("{:>4}: Maze::Node {:.1f} ms, Maze::CompactNode {:.1f} ms", name, wide_ms, compact_ms);
+    };
+    compare("BFS", [&]<typename Node>(const Node& from, const Node& to, const auto& get_neighboors, const auto& indexer) {
+        return algos::BFSFindPath<Node>(from, algos::Equals<Node>{to}, get_neighboors, indexer);
+    });
+    compare("A*", [&]<typename Node>(const Node& from, const Node& to, const auto& get_neighboors, const auto& indexer) {
+        const auto heuristic = [&](const Maze::Node& node) {
+            return std::abs(double(node.x) - double(to.x)) + std::abs(double(node.y) - double(to.y));
+        };
+        return algos::AStarFindPath(from, algos::Equals<Node>{to}, get_neighboors, get_weight, heuristic, indexer);
+    });
+}
+
+void benchmark_landmarks(const BenchmarkParams& params) {
+    const size_t landmark_count = 8;
+    spdlog::info("A* with {} ALT landmarks against octile estimates, {} queries per maze", landmark_count, params.queries);
+    for (const auto algorithm : magic_enum::enum_values<EMazeGenerationAlgorithm>()) {
+        auto maze = generate_maze(algorithm, params.maze_size);
+        maze.add_slow_tiles(0.2);
+        const auto queries = random_queries(maze, params.queries);
+        using Policy = neighboorhood::Diag8Strict;
+        const neighboorhood::Getter<Policy> get_neighboors{&maze};
+        auto get_weight = [&](const Maze::Node& from, const Maze::Node& to) {
+            const double distance = from.x != to.x && from.y != to.y ? 1.4142135623730951 : 1.0;
+            return distance * (maze.get_cell(to) == MazeObject::slow ? 3.0 : 1.0);
+        };
+
+        Stopwatch build_time;
+        const algos::Landmarks landmarks(queries.front().from, get_neighboors, get_weight, maze.get_node_indexer(), landmark_count);
+        const auto build_ms = build_time.elapsed_ms();
+
+        // expanded nodes and time of every kind of estimate: octile, landmarks, greater of both
+        std::array<size_t, 3> expanded{};
+        std::array<double, 3> ms{};
+        size_t mismatches = 0;
+        for (const auto& [from, to] : queries) {
+            auto octile = [&](const Maze::Node& node) {
+                return Policy::open_distance(node, to, 1.4142135623730951);
+            };
+            const auto alt = landmarks.heuristic_to(to);
+            auto both = [&](const Maze::Node& node) {
+                return std::max(octile(node), alt(node));
+            };
+            auto run = [&](size_t kind, const auto& heuristic) {
+                Stopwatch time;
+                const auto path = algos::AStarFindPath(
+                    from,
+                    [&](const Maze::Node& node) {
+                        ++expanded[kind];
+                        return node == to;
+                    },
+                    get_neighboors, get_weight, heuristic, maze.get_node_indexer()
+                );
+                ms[kind] += time.elapsed_ms();
+                return path_cost(path, get_weight);
+            };
+            const auto cost = run(0, octile);
+            if (std::abs(run(1, alt) - cost) > 1e-6 || std::abs(run(2, both) - cost) > 1e-6) {
+                ++mismatches;
+            }
+        }
+        auto change = [&](size_t kind) {
+            return (double(expanded[kind]) / double(std::max<size_t>(expanded[0], 1)) - 1.0) * 100.0;
+        };
+        const auto count = double(queries.size());
+        spdlog::info(
+            "{:>12} {}x{}: build {:.1f} ms | per query: octile {:.0f} nodes in {:.3f} ms, ALT {:+.1f}% nodes in {:.3f} ms, "
+            "greater of both {:+.1f}% nodes in {:.3f} ms | {} cost mismatches",
+            magic_enum::enum_name(algorithm), maze.width, maze.height, build_ms,
+            double(expanded[0]) / count, ms[0] / count, change(1), ms[1] / count, change(2), ms[2] / count, mismatches
+        );
+    }
+}
+
+void benchmark_csr_graph(const BenchmarkParams& params) {
+    using Policy = neighboorhood::Diag8Strict;
+    auto maze = generate_maze(EMazeGenerationAlgorithm::noise, params.maze_size);
+    maze.add_slow_tiles(0.2);
+    const auto get_weight = [&](const Maze::Node& from, const Maze::Node& to) {
+        const double distance = from.x != to.x && from.y != to.y ? 1.4142135623730951 : 1.0;
+        return distance * (maze.get_cell(to) == MazeObject::slow ? 3.0 : 1.0);
+    };
+    util::ThreadPool single_thread(1);
+    util::ThreadPool pool;
+    Stopwatch single_thread_time;
+    algos::CsrGraph::from_maze(maze, Policy{}, get_weight, single_thread);
+    const auto single_thread_ms = single_thread_time.elapsed_ms();
+    Stopwatch build_time;
+    const auto graph = algos::CsrGraph::from_maze(maze, Policy{}, get_weight, pool);
+    spdlog::info(
+        "CSR graph of {} nodes and {} edges built in {:.1f} ms on {} threads, {:.1f} ms on one",
+        graph.node_count(), graph.edge_count(), build_time.elapsed_ms(), pool.size(), single_thread_ms
+    );
+
+    spdlog::info("Grid getters against the CSR graph, {} queries", params.queries);
+    const auto queries = random_queries(maze, params.queries);
+    const auto indexer = maze.get_node_indexer();
+    const algos::CsrNeighboors csr_neighboors{&graph};
+    const algos::CsrWeight csr_weight{&graph};
+    // `find_path` gets both ends as nodes of the graph it searches, its paths are summed up to compare them
+    auto run = [&](const auto& find_path, const auto& to_node, const auto& weight) {
+        Stopwatch time;
+        double cost = 0.0;
+        for (const auto& query : queries) {
+            const auto path = find_path(to_node(query.from), to_node(query.to));
+            for (size_t i = 1; i < path.size(); ++i) {
+                cost += weight(path[i], path[i - 1]);
+            }
+        }
+        return std::pair{time.elapsed_ms(), cost};
+    };
+    // searches run in workspaces, so tables for a million cells are not allocated on every query
+    algos::SearchWorkspace<Maze::Node, Maze::NodeIndexer> grid_workspace(indexer);
+    algos::SearchWorkspace<algos::CsrGraph::Node, algos::CsrGraph::NodeIndexer> csr_workspace(graph.get_node_indexer());
+    auto compare = [&](const char* name, const auto& find_path) {
+        const auto [grid_ms, grid_cost] = run([&](const Maze::Node& from, const Maze::Node& to) {
+            return find_path(from, to, neighboorhood::Getter<Policy>{&maze}, get_weight, grid_workspace, [](const Maze::Node& node) {
+                return node;
+            });
+        }, [](const Maze::Node& node) { return node; }, get_weight);
+        const auto [csr_ms, csr_cost] = run([&](algos::CsrGraph::Node from, algos::CsrGraph::Node to) {
+            return find_path(from, to, csr_neighboors, csr_weight, csr_workspace, [&](algos::CsrGraph::Node node) {
+                return indexer.node(node);
+            });
+        }, [&](const Maze::Node& node) { return algos::CsrGraph::Node(indexer(node)); }, csr_weight);
+        if (std::abs(grid_cost - csr_cost) > 1e-6) {
+            spdlog::error("{} over the CSR graph found paths of total cost {:.1f} instead of {:.1f}", name, csr_cost, grid_cost);
+        }
+        spdlog::info("{:>8}: grid {:.1f} ms, CSR {:.1f} ms", name, grid_ms, csr_ms);
+    };
+    compare("BFS", [&]<typename Node>(const Node& from, const Node& to, const auto& get_neighboors, const auto&, auto& workspace, const auto&) {
+        return algos::BFSFindPath<Node>(from, algos::Equals<Node>{to}, get_neighboors, workspace);
+    });
+    compare("Dijkstra", [&]<typename Node>(const Node& from, const Node& to, const auto& get_neighboors, const auto& weight, auto& workspace, const auto&) {
+        return algos::DijkstraFindPath(from, algos::Equals<Node>{to}, get_neighboors, weight, workspace);
+    });
+    // the graph keeps no coordinates, so `to_cell` turns its nodes back into cells for estimates
+    compare("A*", [&]<typename Node>(const Node& from, const Node& to, const auto& get_neighboors, const auto& weight, auto& workspace, const auto& to_cell) {
+        const Maze::Node target = to_cell(to);
+        const auto heuristic = [&](const Node& node) {
+            return Policy::open_distance(to_cell(node), target, 1.4142135623730951);
+        };
+        return algos::AStarFindPath(from, algos::Equals<Node>{to}, get_neighboors, weight, heuristic, workspace);
+    });
+}
+
+// An edge list with a repeated edge has to keep its cheapest copy, or costs of found paths would not be the costs searches minimised
+void check_csr_parallel_edges() {
+    const auto path = std::filesystem::temp_directory_path() / "algvis_parallel_edges.txt";
+    std::ofstream(path) << "0 1 5\n0 1 2\n1 2\n";
+    const auto graph = algos::CsrGraph::load_edge_list(path);
+    std::filesystem::remove(path);
+    const auto found = algos::DijkstraFindPath<algos::CsrGraph::Node>(
+        0, algos::Equals<algos::CsrGraph::Node>{2}, algos::CsrNeighboors{&graph}, algos::CsrWeight{&graph}
+    );
+    double cost = 0.0;
+    for (size_t i = 1; i < found.size(); ++i) {
+        cost += graph.weight(found[i], found[i - 1]);
+    }
+    if (graph.edge_count() != 2 || graph.weight(0, 1) != 2.0 || cost != 3.0) {
+        spdlog::error("CSR graph kept {} of the parallel edges with weight {:.1f}, path cost {:.1f}", graph.edge_count(), graph.weight(0, 1), cost);
+    } else {
+        spdlog::info("CSR graph merged parallel edges into the cheapest one");
+    }
+}
+
+// Packed binary mazes with bits set past a row end have to be rejected, whole-word scans would count those bits as cells
+void check_binary_maze_padding() {
+    const auto path = std::filesystem::temp_directory_path() / "algvis_padding.bmaze";
+    auto maze = generate_maze(EMazeGenerationAlgorithm::noise, 70);
+    maze.add_slow_tiles(0.2);
+    maze.set_storage(EMazeStorage::packed);
+    maze_file::save_binary(maze, path);
+    std::string bytes;
+    {
+        std::ifstream file(path, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+    const auto layer_size = PackedCells::words_per_row(maze.width) * maze.height;
+    bool all_rejected = true;
+    // last word of the first row in the wall layer and in the slow one
+    for (const auto word : {size_t(1), layer_size + 1}) {
+        auto corrupted = bytes;
+        corrupted[sizeof(maze_file::Header) + word * sizeof(PackedCells::Word) + sizeof(PackedCells::Word) - 1] |= char(0x80);
+        std::ofstream(path, std::ios::binary) << corrupted;
+        try {
+            maze_file::load_binary(path);
+            all_rejected = false;
+        } catch (const std::runtime_error&) {}
+    }
+    std::ofstream(path, std::ios::binary) << bytes;
+    const auto loaded = maze_file::load_binary(path);
+    std::filesystem::remove(path);
+    if (!all_rejected || loaded.has_slow_tiles() != maze.has_slow_tiles()) {
+        spdlog::error("Binary maze loading does not check padding bits of packed rows");
+    } else {
+        spdlog::info("Binary maze loading rejected nonzero padding bits");
+    }
+}
+
+int main(int argc, char** argv) {
+    BenchmarkParams params;
+    if (argc > 1) {
+        params.maze_size = std::stoul(argv[1]);
+    }
+    if (argc > 2) {
+        params.queries = std::stoul(argv[2]);
+    }
+    set_random_seed(1);
+
+    benchmark_hpa(params);
+    benchmark_corridor_graph(params);
+    benchmark_parallel_bfs(params);
+    benchmark_bitboard_bfs(params);
+    benchmark_delta_stepping(params);
+    benchmark_batch_search(params);
+    benchmark_distance_field(params);
+    benchmark_d_star_lite(params);
+    benchmark_ara_star(params);
+    benchmark_neighboorhood_policies(params);
+    benchmark_compact_nodes(params);
+    benchmark_landmarks(params);
+    benchmark_csr_graph(params);
+    check_csr_parallel_edges();
+    check_binary_maze_padding();
+}
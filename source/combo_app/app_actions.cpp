@@ -5,15 +5,19 @@
 namespace rng = std::ranges;
 
 
-void apply_brush_to_grid(int mouse_x, int mouse_y,
-                         Maze& maze,
-                         visual::Grid& grid,
-                         MazeObject type_to_set,
-                         float scale, float dx, float dy) {
+std::vector<Maze::Node> apply_brush_to_grid(int mouse_x, int mouse_y,
+                                            Maze& maze,
+                                            visual::Grid& grid,
+                                            MazeObject type_to_set,
+                                            float scale, float dx, float dy) {
+  std::vector<Maze::Node> changed;
   for_each_brush_affected_tile(mouse_x, mouse_y, maze, grid, scale, dx, dy, [&](int x, int y){
       const auto xsz = size_t(x);
       const auto ysz = size_t(y);
-      auto& maze_cell = maze.get_cell({xsz, ysz});
+      auto maze_cell = maze.get_cell({xsz, ysz});
+      if (maze_cell != type_to_set) {
+        changed.push_back({xsz, ysz});
+      }
       maze_cell = type_to_set;
       grid.set_cell(xsz, ysz, {.color = grid.style().color_map[maze_cell]});
       if (type_to_set == MazeObject::start) {
@@ -22,6 +26,7 @@ void apply_brush_to_grid(int mouse_x, int mouse_y,
         maze.to = util::coords_to_idx(size_t(x), size_t(y), maze.width);
       }
   });
+  return changed;
 }
 
 Maze create_maze(const combo_app_gui::CreationData& gui_data) {
@@ -2,6 +2,7 @@
 
 #include <gui.hpp>
 #include <visual/grid.hpp>
+#include <vector>
 
 
 void for_each_brush_affected_tile(int mouse_x, int mouse_y,
@@ -34,7 +35,8 @@ void for_each_brush_affected_tile(int mouse_x, int mouse_y,
 }
 
 
-void apply_brush_to_grid(int mouse_x, int mouse_y,
+// returns cells whose content was changed
+std::vector<Maze::Node> apply_brush_to_grid(int mouse_x, int mouse_y,
                          Maze& maze,
                          visual::Grid& grid,
                          MazeObject type_to_set,
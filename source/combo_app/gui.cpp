@@ -43,13 +43,47 @@ namespace combo_app_gui {
     }
   }
 
+  static void draw_visualization_progress(const VisualizationProgress& progress) {
+    ImGui::Text("Nodes checked: %lu", progress.nodes_checked);
+
+    if (progress.finished) {
+      if (progress.path_found) {
+        ImGui::Text("Path found! Length = %lu. Cost = %.2f",
+                    progress.path_length,
+                    progress.path_cost);
+      } else {
+        ImGui::Text("Path not found.");
+      }
+    } else {
+      ImGui::Text("Searching...");
+      if (progress.path_found) {
+        ImGui::Text("Best path so far: Length = %lu. Cost = %.2f", progress.path_length, progress.path_cost);
+      }
+    }
+    if (progress.path_found && progress.suboptimality_bound > 1.0) {
+      ImGui::Text("Cost is at most %.2f times the optimal one.", progress.suboptimality_bound);
+    }
+
+    ImGui::Text("Algorithm took %.1fms to run.", progress.processor_time_ms);
+
+    const auto& stats = progress.stats;
+    if (stats.expanded > 0) {
+      ImGui::Text("Expanded: %lu. Discovered: %lu.", stats.expanded, stats.discovered);
+      ImGui::Text("Open list: %lu operations, peak size %lu.", stats.open_list_operations(), stats.peak_open_size);
+      if (!stats.open_size_samples.empty()) {
+        ImGui::PlotLines("Open list size", stats.open_size_samples.data(), int(stats.open_size_samples.size()));
+      }
+    }
+  }
+
   static void draw_creation_gui() {
     auto& data = s_data.creation_data;
 
     int dims[] = {data.maze_width, data.maze_height};
     ImGui::InputInt2("Dimentions", dims);
-    data.maze_width = std::max(dims[0], 1);
-    data.maze_height = std::max(dims[1], 1);
+    // search logs keep Maze::CompactNode
+    data.maze_width = std::clamp(dims[0], 1, int(Maze::max_compact_side));
+    data.maze_height = std::clamp(dims[1], 1, int(Maze::max_compact_side));
 
     ImGui::Separator();
 
@@ -59,6 +93,11 @@ namespace combo_app_gui {
     if (ImGui::Button("Fill with chosen tile")) {
       s_data.creation_data.fill_maze = true;
     }
+    // searched with D* Lite and the pathfinding settings, edits only repair its last search
+    ImGui::Checkbox("Live path", &data.live_path.value);
+    if (data.live_path && s_data.live_path_progress.display) {
+      draw_visualization_progress(s_data.live_path_progress);
+    }
 
     ImGui::Separator();
 
@@ -115,24 +154,6 @@ namespace combo_app_gui {
     }
   }
 
-  static void draw_visualization_progress() {
-    ImGui::Text("Nodes checked: %lu", s_data.visualization_progress.nodes_checked);
-
-    if (s_data.visualization_progress.finished) {
-      if (s_data.visualization_progress.path_found) {
-        ImGui::Text("Path found! Length = %lu. Cost = %.2f",
-                    s_data.visualization_progress.path_length,
-                    s_data.visualization_progress.path_cost);
-      } else {
-        ImGui::Text("Path not found.");
-      }
-    } else {
-      ImGui::Text("Searching...");
-    }
-
-    ImGui::Text("Algorithm took %.1fms to run.", s_data.visualization_progress.processor_time_ms);
-  }
-
   static void draw_visualization_gui() {
     ImGui::Text("Search algorithm");
     visual::imgui::draw_enum_radio_buttons(s_data.visualization_data.algorithm.value, 2);
@@ -141,6 +162,19 @@ namespace combo_app_gui {
     if (s_data.visualization_data.allow_diagonals) {
       ImGui::Checkbox("Require adjacent tiles for diagonal", &s_data.visualization_data.require_adjacent_for_diagonals.value);
     }
+    ImGui::Checkbox("Compress corridors", &s_data.visualization_data.compress_corridors.value);
+    if (s_data.visualization_data.algorithm == EAlgorithm::DeltaStepping) {
+      auto& bucket_width = s_data.visualization_data.bucket_width;
+      ImGui::PushItemWidth(100);
+      ImGui::SliderFloat("Bucket width", &bucket_width.value, bucket_width.min, bucket_width.max);
+    }
+    if (s_data.visualization_data.algorithm == EAlgorithm::ARAStar) {
+      auto& epsilon = s_data.visualization_data.initial_epsilon;
+      auto& budget = s_data.visualization_data.frame_budget_ms;
+      ImGui::PushItemWidth(100);
+      ImGui::SliderFloat("Initial epsilon", &epsilon.value, epsilon.min, epsilon.max);
+      ImGui::SliderFloat("Search ms per frame", &budget.value, budget.min, budget.max);
+    }
 
     {
     auto& time = s_data.visualization_data.desireable_time_per_step;
@@ -156,9 +190,13 @@ namespace combo_app_gui {
     if (ImGui::Button("Pathfind")) {
       s_data.visualization_data.runPathfinding = true;
     }
+    ImGui::SameLine();
+    if (ImGui::Button("Distance field")) {
+      s_data.visualization_data.showDistanceField = true;
+    }
 
     if (s_data.visualization_progress.display) {
-      draw_visualization_progress();
+      draw_visualization_progress(s_data.visualization_progress);
     }
   }
 
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <maze/maze_generation.hpp>
+#include <algos/search_algorithm.hpp>
+#include <algos/search_observer.hpp>
 #include <maze/generation_parameters.hpp>
 #include <util/parameter.hpp>
 
@@ -14,6 +16,8 @@ namespace combo_app_gui{
     PARAMETER(MazeObject, draw_object, MazeObject::wall);
     
     RESTRAINED_PARAMETER(int, brush_size, 1, 1, 100);
+    // path from start to finish kept up to date while painting
+    PARAMETER(bool, live_path, false);
 
     PARAMETER(EMazeGenerationAlgorithm, generation_algorithm, EMazeGenerationAlgorithm::random_dfs);
     bool fill_maze = false;
@@ -38,19 +42,23 @@ namespace combo_app_gui{
     bool do_load = false;
   };
 
-  enum class EAlgorithm {
-      BFS, DFS, RandomDFS, Dijkstra, AStar
-  };
+  using EAlgorithm = algos::EAlgorithm;
 
   struct VisualizationData {
     PARAMETER(EAlgorithm, algorithm);
 
     PARAMETER(bool, allow_diagonals);
     PARAMETER(bool, require_adjacent_for_diagonals);
+    PARAMETER(bool, compress_corridors);
+    RESTRAINED_PARAMETER(float, bucket_width, 1.0f, 0.1f, 20.0f);
+    // ARA* starts with heuristics inflated this much and searches this long every frame
+    RESTRAINED_PARAMETER(float, initial_epsilon, 3.0f, 1.0f, 10.0f);
+    RESTRAINED_PARAMETER(float, frame_budget_ms, 4.0f, 0.5f, 50.0f);
 
     RESTRAINED_PARAMETER(double, desireable_time_per_step, 0.005, 0.0001, 1.0);
 
     bool runPathfinding = false;
+    bool showDistanceField = false;
   };
 
   struct VisualizationProgress {
@@ -61,6 +69,10 @@ namespace combo_app_gui{
     uint64_t path_length;
     double processor_time_ms;
     double path_cost;
+    // path costs at most this many times the optimal one, above 1 only for anytime searches
+    double suboptimality_bound = 1.0;
+    // open list counters, filled by searches that report to an observer
+    algos::SearchStats stats;
   };
 
   enum class AppMode{
@@ -77,6 +89,7 @@ namespace combo_app_gui{
     CreationData creation_data{}; 
     VisualizationData visualization_data{};
     VisualizationProgress visualization_progress{};
+    VisualizationProgress live_path_progress{};
   };
 
   Data& get_data();
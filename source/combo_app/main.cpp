@@ -6,11 +6,27 @@
 #include <gui.hpp>
 #include <app_actions.hpp>
 #include <algorithm>
+#include <limits>
+#include <optional>
+#include <tuple>
+#include <variant>
 
 #include "algos/BFS.hpp"
 #include "algos/DFS.hpp"
 #include "algos/dijkstra.hpp"
 #include "algos/a_star.hpp"
+#include "algos/ara_star.hpp"
+#include "algos/bidirectional.hpp"
+#include "algos/bitboard_bfs.hpp"
+#include "algos/connected_components.hpp"
+#include "algos/jump_point_search.hpp"
+#include "algos/hpa_star.hpp"
+#include "algos/corridor_graph.hpp"
+#include "algos/delta_stepping.hpp"
+#include "algos/distance_field.hpp"
+#include "algos/d_star_lite.hpp"
+#include "algos/stepwise_search.hpp"
+#include "maze/neighboorhood.hpp"
 
 namespace rng = std::ranges;
 
@@ -58,27 +74,10 @@ auto init_display() {
   return display;
 }
 
-using edge_getter_t = std::vector<Maze::Node> (*) (const Maze&, const Maze::Node&);
-
-edge_getter_t create_edge_getter(bool allow_diagonals, bool require_adjacent_for_diagonals) {
-    if (!allow_diagonals) {
-        return [](const Maze& maze, const Maze::Node& node) {
-            return maze.get_cross_neighboors(node);
-        };
-    }
-    if (require_adjacent_for_diagonals) {
-        return [](const Maze& maze, const Maze::Node& node) {
-            return maze.get_sides_and_corners(node, true);
-        };
-    }
-    return [](const Maze& maze, const Maze::Node& node) {
-        return maze.get_sides_and_corners(node, false);
-    };
-}
-
-std::vector<std::pair<Maze::Node, float>> estimates_log;
-std::vector<Maze::Node> search_log;
-std::vector<std::pair<Maze::Node, size_t>> discover_log;
+// logs keep compact nodes, they grow with every expansion. Maze sides are limited in the gui to fit them
+std::vector<std::pair<Maze::CompactNode, float>> estimates_log;
+std::vector<Maze::CompactNode> search_log;
+std::vector<std::pair<Maze::CompactNode, size_t>> discover_log;
 algos::NodePath<Maze::Node> path;
 size_t cur_idx = 0;
 size_t discover_idx = 0;
@@ -93,6 +92,98 @@ void clear_visualization() {
   discover_idx = 0;
 }
 
+// The only move cost of the app: sides cost 1, corners sqrt(2), entering a slow tile multiplies it.
+// Live, replayed and cached searches and the path costs shown all use it
+struct MoveWeight {
+  const Maze* maze;
+  const combo_app_gui::CreationData* creation_data;
+
+  double operator()(const Maze::Node& from, const Maze::Node& to) const {
+    double distance = 1.0;
+    if (from.x != to.x && from.y != to.y) {
+      distance = 1.4142135623730951; // sqrt(2) == diagonal path
+    }
+    return distance * (maze->get_cell(to) == MazeObject::slow ? double(creation_data->slow_tile_cost) : 1.0);
+  }
+};
+
+// Distance on an empty maze for the neighboorhood, Manhattan or octile, times the cheapest cost of a move.
+// D* Lite needs estimates between any two cells consistent with MoveWeight, Dijkstra gets `scale` 0
+template<typename Policy>
+struct OpenDistance {
+  double scale;
+
+  double operator()(const Maze::Node& from, const Maze::Node& to) const {
+    return scale * Policy::open_distance(from, to, 1.4142135623730951);
+  }
+};
+
+template<typename Policy>
+struct TargetDistance {
+  OpenDistance<Policy> distance;
+  Maze::Node target;
+
+  double operator()(const Maze::Node& node) const {
+    return distance(node, target);
+  }
+};
+
+// Neighboors of the step-wise searches, cells they discover are painted as they go. RandomDFS gets them shuffled
+template<typename Policy>
+struct PaintingNeighboors {
+  const Maze* maze;
+  visual::Grid* grid;
+  bool shuffle;
+
+  Maze::NeighboorList operator()(const Maze::Node& node) const {
+    auto neighboors = Policy::get(*maze, node);
+    for (const auto& neighboor : neighboors) {
+      const auto cell = maze->get_cell(neighboor);
+      if (cell != MazeObject::start && cell != MazeObject::finish
+          && grid->get_cell(neighboor.x, neighboor.y).color != grid->style().used_color) {
+        grid->set_cell(neighboor.x, neighboor.y, {.color = grid->style().discovered_color});
+      }
+    }
+    if (shuffle) {
+      std::shuffle(neighboors.begin(), neighboors.end(), get_rengine());
+    }
+    return neighboors;
+  }
+};
+
+// HPA*, the distance field and D* Lite kept between runs, for the neighboorhood they were made with
+template<typename Policy>
+struct CachedEngines {
+  using Neighboors = neighboorhood::Getter<Policy>;
+  std::optional<algos::HierarchicalPathfinder<Neighboors, MoveWeight>> hierarchical_pathfinder;
+  std::optional<algos::DistanceField<Neighboors, MoveWeight>> distance_field;
+  std::optional<algos::DStarLite<Neighboors, MoveWeight, OpenDistance<Policy>>> d_star_lite;
+};
+
+// searches report their open list to the stats shown in the visualization progress
+template<typename Policy>
+using StepwiseBFS = algos::StepwiseBFS<Maze::Node, PaintingNeighboors<Policy>, algos::Equals<Maze::Node>, Maze::NodeIndexer, algos::StatsObserver>;
+template<typename Policy>
+using StepwiseDFS = algos::StepwiseDFS<Maze::Node, PaintingNeighboors<Policy>, algos::Equals<Maze::Node>, Maze::NodeIndexer, algos::StatsObserver>;
+template<typename Policy>
+using StepwiseAStar = algos::StepwiseAStar<
+    Maze::Node, PaintingNeighboors<Policy>, algos::Equals<Maze::Node>, MoveWeight, TargetDistance<Policy>, Maze::NodeIndexer, algos::StatsObserver
+>;
+template<typename Policy>
+using AnytimeSearch = algos::AnytimeRepairingAStar<
+    Maze::Node, neighboorhood::Getter<Policy>, algos::Equals<Maze::Node>, MoveWeight, TargetDistance<Policy>, Maze::NodeIndexer,
+    algos::StatsObserver
+>;
+
+// Engines made for whichever neighboorhood was chosen, their getters call Policy::get directly
+template<template<typename> typename... Engines>
+using PerNeighboorhood = std::variant<
+    std::monostate,
+    Engines<neighboorhood::Cross4>...,
+    Engines<neighboorhood::Diag8Strict>...,
+    Engines<neighboorhood::Diag8Loose>...
+>;
+
 
 int main() {
   visual::initialize();
@@ -117,6 +208,97 @@ int main() {
   auto progress_timer = visual::Timer(1.0);
   queue.register_source(progress_timer.event_source());
 
+  // kept between runs, so precomputed jumps are reused until the maze is edited
+  std::optional<algos::JumpPointSearch> jump_point_search;
+  // workers of delta-stepping, started on its first run and kept for the app's lifetime
+  std::optional<util::ThreadPool> thread_pool;
+  std::optional<algos::BitboardBFS> bitboard_bfs;
+  // regions of free cells, so a search between two of them is not run at all.
+  // Brush edits opening walls are joined in at once, new walls leave a rebuild for the next run
+  std::optional<algos::ConnectedComponents> connected_components;
+  auto endpoints_connected = [&] {
+      const bool allow_diagonals = config.visualization_data.allow_diagonals.value;
+      const bool corners_require_adjacent = config.visualization_data.require_adjacent_for_diagonals.value;
+      if (!connected_components
+          || connected_components->allow_diagonals() != allow_diagonals
+          || connected_components->corners_require_adjacent() != corners_require_adjacent) {
+        connected_components.emplace(maze, allow_diagonals, corners_require_adjacent);
+      }
+      return connected_components->connected(
+          Maze::Node{util::idx_to_coords(maze.from, maze.width)}, Maze::Node{util::idx_to_coords(maze.to, maze.width)}
+      );
+  };
+
+  const MoveWeight cached_weight_getter{&maze, &config.creation_data};
+  auto cached_settings = [&] {
+      return std::tuple{
+          config.visualization_data.allow_diagonals.value,
+          config.visualization_data.require_adjacent_for_diagonals.value,
+          double(config.creation_data.slow_tile_cost)
+      };
+  };
+  auto with_neighboorhood = [&](auto&& visitor) -> decltype(auto) {
+      const auto& data = config.visualization_data;
+      return neighboorhood::dispatch(data.allow_diagonals.value, data.require_adjacent_for_diagonals.value, visitor);
+  };
+  auto cheapest_move = [&] {
+      return std::min(double(config.creation_data.slow_tile_cost), 1.0);
+  };
+  // HPA*, the distance field and D* Lite are kept between runs as well, brush edits are reported to them
+  // so only parts around edited cells are rebuilt. They are made again once the settings they were made for change
+  PerNeighboorhood<CachedEngines> cached_engines;
+  std::tuple<bool, bool, double> cached_engines_settings;
+  auto get_cached_engines = [&](auto policy) -> CachedEngines<decltype(policy)>& {
+      using Engines = CachedEngines<decltype(policy)>;
+      const auto settings = cached_settings();
+      if (!std::holds_alternative<Engines>(cached_engines) || cached_engines_settings != settings) {
+        cached_engines.emplace<Engines>();
+        cached_engines_settings = settings;
+      }
+      return std::get<Engines>(cached_engines);
+  };
+  auto get_d_star_lite = [&](auto policy) -> auto& {
+      using Policy = decltype(policy);
+      auto& d_star_lite = get_cached_engines(policy).d_star_lite;
+      if (!d_star_lite) {
+        d_star_lite.emplace(maze, neighboorhood::Getter<Policy>{&maze}, cached_weight_getter, OpenDistance<Policy>{cheapest_move()});
+      }
+      return *d_star_lite;
+  };
+  // ARA* started by Pathfind keeps searching for a few milliseconds every frame and shows each better path it finds.
+  // It is dropped when the maze or settings change under it
+  PerNeighboorhood<AnytimeSearch> anytime_search;
+  uint64_t anytime_search_revision = 0;
+  std::tuple<bool, bool, double> anytime_search_settings;
+
+  // BFS, DFS, Dijkstra and A* over maze cells are not run up front: every progress tick expands one more cell
+  // and paints it, so big mazes do not freeze the app and nothing is recorded for a replay.
+  // The search is dropped when the maze changes or another one starts
+  uint64_t stepwise_revision = 0;
+  std::optional<Maze::Node> stepwise_last_expanded;
+  auto paint_searched_cell = [&](const Maze::Node& node, ALLEGRO_COLOR color) {
+      const auto cell = maze.get_cell(node);
+      if (cell != MazeObject::start && cell != MazeObject::finish) {
+        grid.set_cell(node.x, node.y, {.color = color});
+      }
+  };
+  // the neighboorhood is picked once when a search starts, it is compiled for it
+  PerNeighboorhood<StepwiseBFS, StepwiseDFS, StepwiseAStar> stepwise_search;
+
+  // cells of the live path drawn over the maze and the revision they were found for
+  algos::NodePath<Maze::Node> live_path_cells;
+  uint64_t live_path_revision = 0;
+  auto erase_live_path = [&] {
+      for (const auto& node : live_path_cells) {
+        if (maze.is_valid(node)) {
+          grid.set_cell(node.x, node.y, {.color = grid.style().color_map[maze.get_cell(node)]});
+        }
+      }
+      live_path_cells.clear();
+      live_path_revision = 0;
+      config.live_path_progress.display = false;
+  };
+
   auto react_to_gui = [&, prev_mode = config.m_mode] mutable {
 #ifndef __EMSCRIPTEN__
     // many potentially slow operations below, so pausing draw timer while here
@@ -127,6 +309,8 @@ int main() {
       if (prev_mode == combo_app_gui::AppMode::PathFinding) {
         grid.update(maze);
         config.visualization_progress.display = false;
+        // redrawn on the next frame
+        live_path_revision = 0;
       }
       prev_mode = config.m_mode;
     }
@@ -170,7 +354,7 @@ int main() {
 
     if (config.creation_data.fill_maze) {
       config.creation_data.fill_maze = false;
-      rng::fill(maze.items, config.creation_data.draw_object);
+      maze.fill(config.creation_data.draw_object);
       grid.update(maze);
     }
 
@@ -181,6 +365,132 @@ int main() {
       grid.update(maze);
     }
 
+    // a new search replaces whatever is still running across frames, ARA* included.
+    // An ARA* run is started again below when it is the chosen algorithm
+    if (config.visualization_data.runPathfinding) {
+      stepwise_search.emplace<std::monostate>();
+      stepwise_last_expanded.reset();
+      anytime_search.emplace<std::monostate>();
+    }
+
+    const auto pathfinding_algorithm = config.visualization_data.algorithm.value;
+    const bool runs_stepwise = !config.visualization_data.compress_corridors.value
+        && (pathfinding_algorithm == combo_app_gui::EAlgorithm::BFS
+            || pathfinding_algorithm == combo_app_gui::EAlgorithm::DFS
+            || pathfinding_algorithm == combo_app_gui::EAlgorithm::RandomDFS
+            || pathfinding_algorithm == combo_app_gui::EAlgorithm::Dijkstra
+            || pathfinding_algorithm == combo_app_gui::EAlgorithm::AStar);
+    if (config.visualization_data.runPathfinding && runs_stepwise) {
+      config.visualization_data.runPathfinding = false;
+      clear_visualization();
+      grid.update(maze);
+      config.visualization_progress = {};
+      config.visualization_progress.display = true;
+      if (maze.from < maze.cell_count() && maze.to < maze.cell_count() && endpoints_connected()) {
+        const Maze::Node from {util::idx_to_coords(maze.from, maze.width)};
+        const Maze::Node to {util::idx_to_coords(maze.to, maze.width)};
+        stepwise_revision = maze.revision;
+        const algos::Equals<Maze::Node> is_target{to};
+        const algos::StatsObserver stats_observer{config.visualization_progress.stats};
+        with_neighboorhood([&](auto policy) {
+          using Policy = decltype(policy);
+          const PaintingNeighboors<Policy> neighboors{&maze, &grid, pathfinding_algorithm == combo_app_gui::EAlgorithm::RandomDFS};
+          switch (pathfinding_algorithm) {
+            case combo_app_gui::EAlgorithm::BFS:
+              stepwise_search.emplace<StepwiseBFS<Policy>>(from, is_target, neighboors, maze.get_node_indexer(), stats_observer);
+              break;
+            case combo_app_gui::EAlgorithm::DFS:
+            case combo_app_gui::EAlgorithm::RandomDFS:
+              stepwise_search.emplace<StepwiseDFS<Policy>>(from, is_target, neighboors, maze.get_node_indexer(), stats_observer);
+              break;
+            default: {
+              const double scale = pathfinding_algorithm == combo_app_gui::EAlgorithm::AStar ? cheapest_move() : 0.0;
+              stepwise_search.emplace<StepwiseAStar<Policy>>(
+                  from, is_target, neighboors, cached_weight_getter, TargetDistance<Policy>{{scale}, to}, maze.get_node_indexer(), stats_observer
+              );
+              break;
+            }
+          }
+        });
+        auto timePerStep = config.visualization_data.desireable_time_per_step <= 0.0 ? 0.0001 : config.visualization_data.desireable_time_per_step;
+        progress_timer.change_rate(timePerStep);
+        progress_timer.start();
+      } else {
+        config.visualization_progress.finished = true;
+        spdlog::info("No way!. Checked 0 nodes");
+      }
+    }
+
+    if (config.visualization_data.runPathfinding && config.visualization_data.algorithm == combo_app_gui::EAlgorithm::ARAStar) {
+      config.visualization_data.runPathfinding = false;
+      clear_visualization();
+      progress_timer.stop();
+      grid.update(maze);
+      anytime_search.emplace<std::monostate>();
+      config.visualization_progress = {};
+      config.visualization_progress.display = true;
+      if (maze.from < maze.cell_count() && maze.to < maze.cell_count() && endpoints_connected()) {
+        const Maze::Node from {util::idx_to_coords(maze.from, maze.width)};
+        const Maze::Node to {util::idx_to_coords(maze.to, maze.width)};
+        const algos::AnytimeSchedule schedule{double(config.visualization_data.initial_epsilon.value), 0.5};
+        with_neighboorhood([&](auto policy) {
+          using Policy = decltype(policy);
+          anytime_search.emplace<AnytimeSearch<Policy>>(
+              from, algos::Equals<Maze::Node>{to}, neighboorhood::Getter<Policy>{&maze}, cached_weight_getter,
+              TargetDistance<Policy>{{cheapest_move()}, to}, maze.get_node_indexer(), schedule, algos::StatsObserver{config.visualization_progress.stats}
+          );
+        });
+        anytime_search_revision = maze.revision;
+        anytime_search_settings = cached_settings();
+      } else {
+        config.visualization_progress.finished = true;
+        spdlog::info("No way!. Checked 0 nodes");
+      }
+    }
+
+    std::visit([&](auto& search) {
+      if constexpr (std::is_same_v<std::decay_t<decltype(search)>, std::monostate>) {
+        return;
+      } else if (config.m_mode != combo_app_gui::AppMode::PathFinding
+          || anytime_search_revision != maze.revision
+          || anytime_search_settings != cached_settings()) {
+        anytime_search.template emplace<std::monostate>();
+      } else {
+        auto& progress = config.visualization_progress;
+        auto paint_cell = [&](const Maze::Node& node, ALLEGRO_COLOR color) {
+          const auto cell = maze.get_cell(node);
+          if (cell != MazeObject::start && cell != MazeObject::finish) {
+            grid.set_cell(node.x, node.y, {.color = color});
+          }
+        };
+        clock_t start = clock();
+        const bool improved = search.improve({.milliseconds = double(config.visualization_data.frame_budget_ms.value)}, [&](const Maze::Node& node) {
+          ++progress.nodes_checked;
+          paint_cell(node, grid.style().used_color);
+        });
+        clock_t end = clock();
+        progress.processor_time_ms += (double(end - start)) * 1000.0 / CLOCKS_PER_SEC;
+        if (improved) {
+          for (const auto& node : path) {
+            paint_cell(node, grid.style().used_color);
+          }
+          path = search.path();
+          for (const auto& node : path) {
+            paint_cell(node, grid.style().path_color);
+          }
+          progress.path_found = true;
+          progress.path_length = path.size();
+          progress.path_cost = search.path_cost();
+          progress.suboptimality_bound = search.suboptimality_bound();
+        }
+        if (search.is_finished()) {
+          progress.finished = true;
+          progress.suboptimality_bound = path.empty() ? 1.0 : search.suboptimality_bound();
+          anytime_search.template emplace<std::monostate>();
+        }
+      }
+    }, anytime_search);
+
     if (config.visualization_data.runPathfinding) {
       config.visualization_data.runPathfinding = false;
       clear_visualization();
@@ -188,70 +498,174 @@ int main() {
       Maze::Node from {util::idx_to_coords(maze.from, maze.width)};
       Maze::Node to {util::idx_to_coords(maze.to, maze.width)};
 
-      auto edge_getter = create_edge_getter(
-          config.visualization_data.allow_diagonals.value,
-          config.visualization_data.require_adjacent_for_diagonals.value
-      );
-      auto logging_edge_getter = [&](const Maze::Node& node) {
-          auto neighboors = edge_getter(maze, node);
-          rng::transform(neighboors, std::back_inserter(discover_log), [&](const Maze::Node& n) {
-              return std::pair{n, search_log.size()};
-          });
-          return neighboors;
-      };
-      auto random_logging_edge_getter = [&](const Maze::Node& node) {
-          auto neighboors = logging_edge_getter(node);
-          auto& rengine = get_rengine();
-          std::shuffle(neighboors.begin(), neighboors.end(), rengine);
-          return neighboors;
-      };
       auto logging_searcher = [&](const Maze::Node& node) {
-          search_log.push_back(node);
+          search_log.emplace_back(node);
           return node == to;
       };
-      auto weight_getter = [&](const Maze::Node& from, const Maze::Node& to) {
-          double distance = 1.0;
-          if (from.x != to.x && from.y != to.y) {
-            distance = 1.4142135623730951; // sqrt(2) == diagonal path
-          }
-          return distance * (maze.get_cell(to) == MazeObject::slow ? double(config.creation_data.slow_tile_cost) : 1.0);
-      };
-
-      auto logging_estimate_getter = [&](const Maze::Node& node) {
-          auto dx = node.x - to.x;
-          auto dy = node.y - to.y;
-          auto estimate = std::sqrt(dx * dx + dy * dy);
-          estimates_log.push_back({node, estimate});
-          return estimate;
+      auto logging_expander = [&](const Maze::Node& node) {
+          search_log.emplace_back(node);
       };
 
+      const auto algorithm = config.visualization_data.algorithm.value;
+      const bool use_corridor_graph = config.visualization_data.compress_corridors.value
+          && algorithm != combo_app_gui::EAlgorithm::JPS
+          && algorithm != combo_app_gui::EAlgorithm::HPAStar
+          && algorithm != combo_app_gui::EAlgorithm::DeltaStepping
+          && algorithm != combo_app_gui::EAlgorithm::DStarLite
+          && algorithm != combo_app_gui::EAlgorithm::BitboardBFS;
+      // filled by the searches that report to an observer, the others leave it empty
+      algos::SearchStats search_stats;
+      const algos::StatsObserver stats_observer{search_stats};
+      // neighboorhood is picked once, searches below are compiled for it
       clock_t start = clock();
-      path = [&] {
-          using namespace algos;
-          switch (config.visualization_data.algorithm.value) {
-              case combo_app_gui::EAlgorithm::BFS: {
-                  return BFSFindPath<Maze::Node>(from, logging_searcher, logging_edge_getter);
-              }
-              case combo_app_gui::EAlgorithm::DFS: {
-                  return DFSFindPath<Maze::Node>(from, logging_searcher, logging_edge_getter);
-              }
-              case combo_app_gui::EAlgorithm::RandomDFS: {
-                  return DFSFindPath<Maze::Node>(from, logging_searcher, random_logging_edge_getter);
-              }
-              case combo_app_gui::EAlgorithm::Dijkstra: {
-                  return DijkstraFindPath(from, logging_searcher, logging_edge_getter, weight_getter);
-              }
-              case combo_app_gui::EAlgorithm::AStar: {
-                  return AStarFindPath(from, logging_searcher, logging_edge_getter, weight_getter, logging_estimate_getter);
-              }
-          }
-          // should not be reachable. Kept here for now because of gcc warning(end of non-void finction)
-          throw std::logic_error("Unknown algorithm!");
-      }();
+      const auto& visualization_data = config.visualization_data;
+      path = neighboorhood::dispatch(visualization_data.allow_diagonals.value, visualization_data.require_adjacent_for_diagonals.value, [&](auto policy) {
+        // nothing is logged, so the replay ends at once with "No way!"
+        if (!endpoints_connected()) {
+          return algos::NodePath<Maze::Node>{};
+        }
+        const neighboorhood::Getter<decltype(policy)> grid_neighboors{&maze};
+        const OpenDistance<decltype(policy)> cell_distance{cheapest_move()};
+        auto logging_estimate_getter = [&](const Maze::Node& node) {
+            const auto estimate = cell_distance(node, to);
+            estimates_log.push_back({Maze::CompactNode(node), float(estimate)});
+            return estimate;
+        };
+        auto estimate_to_source_getter = [&](const Maze::Node& node) {
+            return cell_distance(from, node);
+        };
+        algos::CorridorGraph corridor_graph(maze, grid_neighboors, cached_weight_getter);
+        const auto max_cost = use_corridor_graph
+            ? corridor_graph.max_edge_weight()
+            : std::max(double(config.creation_data.slow_tile_cost), 1.0) * 1.4142135623730951;
+
+        // runs the chosen algorithm on maze cells or on the corridor graph, which have the same kind of getters
+        auto search = [&](const Maze::Node&, const Maze::Node&, const auto& get_neighboors, const auto& get_weight, const auto& indexer) {
+            auto logging_edge_getter = [&](const Maze::Node& node) {
+                auto neighboors = get_neighboors(node);
+                rng::transform(neighboors, std::back_inserter(discover_log), [&](const Maze::Node& n) {
+                    return std::pair{Maze::CompactNode(n), search_log.size()};
+                });
+                return neighboors;
+            };
+            auto random_logging_edge_getter = [&](const Maze::Node& node) {
+                auto neighboors = logging_edge_getter(node);
+                auto& rengine = get_rengine();
+                std::shuffle(neighboors.begin(), neighboors.end(), rengine);
+                return neighboors;
+            };
+
+            using namespace algos;
+            switch (algorithm) {
+                case combo_app_gui::EAlgorithm::BFS: {
+                    return BFSFindPath<Maze::Node>(from, logging_searcher, logging_edge_getter, indexer, reconstruct_path<Maze::Node>, stats_observer);
+                }
+                case combo_app_gui::EAlgorithm::DFS: {
+                    return DFSFindPath<Maze::Node>(from, logging_searcher, logging_edge_getter, reconstruct_path<Maze::Node>, stats_observer);
+                }
+                case combo_app_gui::EAlgorithm::RandomDFS: {
+                    return DFSFindPath<Maze::Node>(from, logging_searcher, random_logging_edge_getter, reconstruct_path<Maze::Node>, stats_observer);
+                }
+                case combo_app_gui::EAlgorithm::Dijkstra: {
+                    return DijkstraFindPath(from, logging_searcher, logging_edge_getter, get_weight, indexer, reconstruct_path<Maze::Node>, stats_observer);
+                }
+                case combo_app_gui::EAlgorithm::Dial: {
+                    // bucket queue needs integer weights, so costs are taken in fixed point with 2 decimal digits
+                    const FixedPointWeight fixed_weight{get_weight, 100.0};
+                    return DialFindPath(
+                        from, logging_searcher, logging_edge_getter, fixed_weight, fixed_weight.to_fixed(max_cost), indexer,
+                        reconstruct_path<Maze::Node>, stats_observer
+                    );
+                }
+                case combo_app_gui::EAlgorithm::AStar: {
+                    return AStarFindPath(
+                        from, logging_searcher, logging_edge_getter, get_weight, logging_estimate_getter, indexer,
+                        reconstruct_path<Maze::Node>, stats_observer
+                    );
+                }
+                case combo_app_gui::EAlgorithm::JPS: {
+                    const bool corners_require_adjacent = config.visualization_data.require_adjacent_for_diagonals.value;
+                    if (!config.visualization_data.allow_diagonals.value || maze.has_slow_tiles()) {
+                        spdlog::warn("Jump point search needs diagonal moves and no slow tiles, running A* instead");
+                        return AStarFindPath(
+                            from, logging_searcher, logging_edge_getter, get_weight, logging_estimate_getter, indexer,
+                            reconstruct_path<Maze::Node>, stats_observer
+                        );
+                    }
+                    if (!jump_point_search || jump_point_search->corners_require_adjacent() != corners_require_adjacent) {
+                        jump_point_search.emplace(maze, corners_require_adjacent, true);
+                    }
+                    return jump_point_search->find_path(from, to, logging_expander, stats_observer);
+                }
+                case combo_app_gui::EAlgorithm::BidirectionalBFS: {
+                    return BidirectionalBFSFindPath(
+                        from, to, logging_edge_getter, indexer, reconstruct_path<Maze::Node>, logging_expander, stats_observer
+                    );
+                }
+                case combo_app_gui::EAlgorithm::BidirectionalAStar: {
+                    return BidirectionalAStarFindPath(
+                        from, to, logging_edge_getter, get_weight, logging_estimate_getter, estimate_to_source_getter,
+                        indexer, reconstruct_path<Maze::Node>, logging_expander, stats_observer
+                    );
+                }
+                case combo_app_gui::EAlgorithm::HPAStar: {
+                    auto& hierarchical_pathfinder = get_cached_engines(policy).hierarchical_pathfinder;
+                    if (!hierarchical_pathfinder) {
+                        hierarchical_pathfinder.emplace(maze, grid_neighboors, cached_weight_getter);
+                    }
+                    return hierarchical_pathfinder->find_path(from, to, logging_estimate_getter, logging_expander, stats_observer);
+                }
+                case combo_app_gui::EAlgorithm::DeltaStepping: {
+                    if (!thread_pool) {
+  #ifdef __EMSCRIPTEN__
+                      // web build is made without thread support
+                      thread_pool.emplace(1);
+  #else
+                      thread_pool.emplace();
+  #endif
+                    }
+                    const auto bucket_width = double(config.visualization_data.bucket_width.value);
+                    const auto tree = DeltaSteppingShortestPaths(
+                        from, grid_neighboors, cached_weight_getter, maze.get_node_indexer(), bucket_width, *thread_pool, stats_observer
+                    );
+                    // nodes are shown in the order a serial search would settle them
+                    const auto settled = tree.nodes_by_distance(tree.distance(to));
+                    rng::transform(settled, std::back_inserter(search_log), [](const Maze::Node& node) {
+                        return Maze::CompactNode(node);
+                    });
+                    return tree.path_to(to);
+                }
+                case combo_app_gui::EAlgorithm::DStarLite: {
+                    // after brush edits only the repaired part of the previous search is shown
+                    return get_d_star_lite(policy).find_path(from, to, logging_expander, stats_observer);
+                }
+                case combo_app_gui::EAlgorithm::ARAStar: {
+                    // started before getting here, it runs across frames
+                    break;
+                }
+                case combo_app_gui::EAlgorithm::BitboardBFS: {
+                    const bool allow_diagonals = config.visualization_data.allow_diagonals.value;
+                    const bool corners_require_adjacent = config.visualization_data.require_adjacent_for_diagonals.value;
+                    if (!bitboard_bfs || bitboard_bfs->allow_diagonals() != allow_diagonals || bitboard_bfs->corners_require_adjacent() != corners_require_adjacent) {
+                        bitboard_bfs.emplace(maze, allow_diagonals, corners_require_adjacent);
+                    }
+                    return bitboard_bfs->find_path(from, to, logging_expander, stats_observer);
+                }
+            }
+            // should not be reachable. Kept here for now because of gcc warning(end of non-void finction)
+            throw std::logic_error("Unknown algorithm!");
+        };
+
+        return use_corridor_graph
+            ? corridor_graph.find_path(from, to, search)
+            : search(from, to, grid_neighboors, cached_weight_getter, maze.get_node_indexer());
+      });
       clock_t end = clock();
       const auto timeMs = (double(end - start)) * 1000.0 / CLOCKS_PER_SEC;
       //TODO: causes asan error spdlog::info("Processor time taken(ms): {}", timeMs);
+      config.visualization_progress = {};
       config.visualization_progress.processor_time_ms = timeMs;
+      config.visualization_progress.stats = std::move(search_stats);
       config.visualization_progress.finished = false;
       config.visualization_progress.display = true;
 
@@ -260,6 +674,100 @@ int main() {
       progress_timer.start();
     }
 
+    if (config.visualization_data.showDistanceField) {
+      config.visualization_data.showDistanceField = false;
+      clear_visualization();
+      progress_timer.stop();
+      stepwise_search.emplace<std::monostate>();
+      stepwise_last_expanded.reset();
+      anytime_search.emplace<std::monostate>();
+      grid.update(maze);
+      with_neighboorhood([&](auto policy) {
+        auto& distance_field = get_cached_engines(policy).distance_field;
+        if (!distance_field) {
+          distance_field.emplace(maze, neighboorhood::Getter<decltype(policy)>{&maze}, cached_weight_getter);
+        }
+        clock_t start = clock();
+        distance_field->update();
+        clock_t end = clock();
+
+        // cells are shaded by their distance to the finish, unreachable ones keep their colors
+        const auto max_distance = std::max(distance_field->max_distance(), 1.0f);
+        size_t reachable = 0;
+        for (size_t y = 0; y < maze.height; ++y) {
+          for (size_t x = 0; x < maze.width; ++x) {
+            const auto distance = distance_field->distance({x, y});
+            if (distance == std::numeric_limits<float>::infinity()) {
+              continue;
+            }
+            ++reachable;
+            const auto cell = maze.get_cell({x, y});
+            if (cell != MazeObject::start && cell != MazeObject::finish) {
+              grid.set_cell(x, y, {.color = grid.distance_color(distance / max_distance)});
+            }
+          }
+        }
+        const Maze::Node from {util::idx_to_coords(maze.from, maze.width)};
+        path = maze.from < maze.cell_count() ? distance_field->path_from(from) : algos::NodePath<Maze::Node>{};
+        for (const auto& node : path) {
+          const auto cell = maze.get_cell(node);
+          if (cell != MazeObject::start && cell != MazeObject::finish) {
+            grid.set_cell(node.x, node.y, {.color = grid.style().path_color});
+          }
+        }
+
+        auto& progress = config.visualization_progress;
+        progress = {};
+        progress.processor_time_ms = (double(end - start)) * 1000.0 / CLOCKS_PER_SEC;
+        progress.nodes_checked = reachable;
+        progress.path_found = !path.empty();
+        progress.path_length = path.size();
+        progress.path_cost = path.empty() ? 0.0 : double(distance_field->distance(from));
+        progress.finished = true;
+        progress.display = true;
+      });
+    }
+
+    if (config.creation_data.live_path && config.m_mode == combo_app_gui::AppMode::Creation) {
+      // found again after every edit, D* Lite only repairs the part of its last search that the edit affected
+      if (live_path_revision != maze.revision) {
+        erase_live_path();
+        live_path_revision = maze.revision;
+        if (maze.from < maze.cell_count() && maze.to < maze.cell_count()) {
+          const Maze::Node from {util::idx_to_coords(maze.from, maze.width)};
+          const Maze::Node to {util::idx_to_coords(maze.to, maze.width)};
+          uint64_t expanded = 0;
+          clock_t start = clock();
+          live_path_cells = with_neighboorhood([&](auto policy) {
+            return get_d_star_lite(policy).find_path(from, to, [&](const Maze::Node&) {
+              ++expanded;
+            });
+          });
+          clock_t end = clock();
+
+          auto& progress = config.live_path_progress;
+          progress.nodes_checked = expanded;
+          progress.path_found = !live_path_cells.empty();
+          progress.path_length = live_path_cells.size();
+          progress.path_cost = 0.0;
+          for (size_t i = 1; i < live_path_cells.size(); ++i) {
+            progress.path_cost += cached_weight_getter(live_path_cells[i], live_path_cells[i - 1]);
+          }
+          progress.processor_time_ms = (double(end - start)) * 1000.0 / CLOCKS_PER_SEC;
+          progress.finished = true;
+          progress.display = true;
+          for (const auto& node : live_path_cells) {
+            const auto cell = maze.get_cell(node);
+            if (cell != MazeObject::start && cell != MazeObject::finish) {
+              grid.set_cell(node.x, node.y, {.color = grid.style().path_color});
+            }
+          }
+        }
+      }
+    } else if (live_path_revision != 0) {
+      erase_live_path();
+    }
+
     {
     // Make sure maze is on the screen
 
@@ -389,12 +897,32 @@ int main() {
       return;
     }
         
+    auto paint = [&](int x, int y) {
+      const auto revision = maze.revision;
+      const auto changed = apply_brush_to_grid(x, y, maze, grid, type_to_set, config.scale, config.panDx, config.panDy);
+      std::visit([&](auto& engines) {
+        if constexpr (!std::is_same_v<std::decay_t<decltype(engines)>, std::monostate>) {
+          if (engines.hierarchical_pathfinder) {
+            engines.hierarchical_pathfinder->cells_changed(changed, revision);
+          }
+          if (engines.distance_field) {
+            engines.distance_field->cells_changed(changed, revision);
+          }
+          if (engines.d_star_lite) {
+            engines.d_star_lite->cells_changed(changed, revision);
+          }
+        }
+      }, cached_engines);
+      if (connected_components) {
+        connected_components->cells_changed(changed, revision);
+      }
+    };
     auto cur = std::pair{state.x, state.y};
     if (last_mouse_pos == std::pair{-1, -1}) {
-      apply_brush_to_grid(cur.first, cur.second, maze, grid, type_to_set, config.scale, config.panDx, config.panDy);
+      paint(cur.first, cur.second);
     }
     while (cur != last_mouse_pos && last_mouse_pos != std::pair{-1, -1}) {
-      apply_brush_to_grid(cur.first, cur.second, maze, grid, type_to_set, config.scale, config.panDx, config.panDy);
+      paint(cur.first, cur.second);
       if (cur.first != last_mouse_pos.first) {
         cur.first += cur.first < last_mouse_pos.first ? 1 : -1;
       }
@@ -416,9 +944,59 @@ int main() {
     }
     grid.set_cell(x, y, {.color = color});
   };
+  // one more expansion of the step-wise search, returns false when there is none running
+  auto advance_stepwise_search = [&] {
+      return std::visit([&](auto& search) {
+          if constexpr (std::is_same_v<std::decay_t<decltype(search)>, std::monostate>) {
+              return false;
+          } else {
+              auto& progress = config.visualization_progress;
+              if (stepwise_revision != maze.revision) {
+                  progress_timer.stop();
+                  stepwise_search.template emplace<std::monostate>();
+                  return true;
+              }
+              if (stepwise_last_expanded) {
+                  paint_searched_cell(*stepwise_last_expanded, grid.style().used_color);
+              }
+              clock_t start = clock();
+              const bool finished = search.step({.expansions = 1}, [&](const Maze::Node& node) {
+                  stepwise_last_expanded = node;
+                  paint_searched_cell(node, grid.style().last_used_color);
+              });
+              clock_t end = clock();
+              progress.processor_time_ms += (double(end - start)) * 1000.0 / CLOCKS_PER_SEC;
+              progress.nodes_checked = search.expanded();
+              if (!finished) {
+                  return true;
+              }
+              path = search.path();
+              for (const auto& node : path) {
+                  paint_searched_cell(node, grid.style().path_color);
+              }
+              progress.finished = true;
+              progress.path_found = !path.empty();
+              progress.path_length = path.size();
+              progress.path_cost = 0.0;
+              for (size_t i = 1; i < path.size(); ++i) {
+                  progress.path_cost += cached_weight_getter(path[i], path[i - 1]);
+              }
+              spdlog::info("Path length: {}. Checked {} nodes", path.size(), search.expanded());
+              progress_timer.stop();
+              stepwise_last_expanded.reset();
+              stepwise_search.template emplace<std::monostate>();
+              queue.drop_all();
+              return true;
+          }
+      }, stepwise_search);
+  };
   queue.add_reaction(progress_timer.event_source(), [&] (const auto&) mutable {
       if (config.m_mode != combo_app_gui::AppMode::PathFinding) {
         progress_timer.stop();
+        stepwise_search.emplace<std::monostate>();
+        return;
+      }
+      if (advance_stepwise_search()) {
         return;
       }
       config.visualization_progress.nodes_checked = cur_idx;
@@ -432,15 +1010,8 @@ int main() {
           if (path.empty()) {
               spdlog::info("No way!. Checked {} nodes", search_log.size());
           } else {
-              auto weight_getter = [&](const Maze::Node& from, const Maze::Node& to) {
-                  double distance = 1.0;
-                  if (from.x != to.x && from.y != to.y) {
-                    distance = 1.4142135623730951; // sqrt(2) == diagonal path
-                  }
-                  return distance * (maze.get_cell(to) == MazeObject::slow ? double(config.creation_data.slow_tile_cost) : 1.0);
-              };
               for (size_t i = 1; i < path.size(); ++i) {
-                cost += weight_getter(path[i-1], path[i]);
+                cost += cached_weight_getter(path[i], path[i - 1]);
               }
               spdlog::info("Path length: {}. Checked {} nodes", path.size(), search_log.size());
           }
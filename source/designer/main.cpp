@@ -75,7 +75,7 @@ int main() {
 
         if (gui_data.fill_maze) {
             gui_data.fill_maze = false;
-            rng::fill(maze.items, gui_data.draw_object);
+            maze.fill(gui_data.draw_object);
             grid.update(maze);
         }
 
@@ -165,7 +165,7 @@ int main() {
                 }
                 const auto xsz = size_t(x);
                 const auto ysz = size_t(y);
-                auto& maze_cell = maze.get_cell({xsz, ysz});
+                auto maze_cell = maze.get_cell({xsz, ysz});
                 maze_cell = type_to_set;
                 grid.set_cell(xsz, ysz, {.color = grid.style().color_map[maze_cell]});
             }
@@ -38,7 +38,7 @@ Maze generate_binary_tree(size_t width, size_t height, float horizontal_prob) {
             } else {
                 maze.get_cell({w, h + 1}) = MazeObject::space;
             }
-            auto& cur = maze.get_cell({w, h});
+            auto cur = maze.get_cell({w, h});
             if (cur == MazeObject::wall) {
                 cur = MazeObject::space;
             }
@@ -1,4 +1,5 @@
 #include "maze.hpp"
+#include "maze_file.hpp"
 
 #include <util/util.hpp>
 #include <util/random_utils.hpp>
@@ -6,16 +7,26 @@
 #include <algorithm>
 #include <iterator>
 #include <fstream>
+#include <atomic>
 
 namespace rng = std::ranges;
 
+static std::atomic<uint64_t> s_last_revision = 0;
 
-Maze::Maze(size_t width, size_t height, MazeObject default_tile)
+
+Maze::Maze(size_t width, size_t height, MazeObject default_tile, EMazeStorage storage)
     : width(width)
     , height(height)
     , from(0)
     , to(0)
-    , items(width * height, default_tile) { }
+    , storage(storage)
+    , items(storage == EMazeStorage::bytes ? width * height : 0, default_tile)
+    , packed(storage == EMazeStorage::packed ? PackedCells(width, height) : PackedCells())
+    , revision(++s_last_revision) {
+    if (storage == EMazeStorage::packed) {
+        fill(default_tile);
+    }
+}
 
 
 void Maze::add_random_start_finish(Maze& maze) {
@@ -26,70 +37,195 @@ void Maze::add_random_start_finish(Maze& maze) {
     to.y = std::uniform_int_distribution<size_t>(0, maze.height - 1)(rengine);
     maze.from = util::coords_to_idx(from.x, from.y, maze.width);
     maze.to = util::coords_to_idx(to.x, to.y, maze.width);
-    maze.items[maze.from] = MazeObject::start;
-    maze.items[maze.to] = MazeObject::finish;
+    maze.set_cell(maze.from, MazeObject::start);
+    maze.set_cell(maze.to, MazeObject::finish);
 }
 
 void Maze::add_slow_tiles(double change_probability) {
-    for (auto& cell : items) {
-        if (cell == MazeObject::space && chance(change_probability)) {
-            cell = MazeObject::slow;
+    mark_modified();
+    if (storage == EMazeStorage::bytes) {
+        for (auto& cell : items) {
+            if (cell == MazeObject::space && chance(change_probability)) {
+                cell = MazeObject::slow;
+            }
+        }
+        return;
+    }
+    for (size_t index = 0; index < cell_count(); ++index) {
+        if (get_cell(index) == MazeObject::space && chance(change_probability)) {
+            set_cell(index, MazeObject::slow);
         }
     }
 }
 
 void Maze::resize(size_t new_width, size_t new_height) {
-    Maze new_maze(new_width, new_height);
+    Maze new_maze(new_width, new_height, MazeObject::space, storage);
     for (size_t x = 0; x < std::min(new_width, width); ++x) {
         for (size_t y = 0; y < std::min(new_height, height); ++y) {
-            new_maze.get_cell({x, y}) = get_cell({x, y});
+            new_maze.get_cell({x, y}) = get_cell(Node{x, y});
         }
     }
     *this = std::move(new_maze);
 }
 
-Maze Maze::load(const std::filesystem::path& path) {
-    std::fstream file(path, std::ios::in);
-    size_t width;
-    size_t height;
-    file >> width >> height;
-    Maze maze(width, height);
+void Maze::fill(MazeObject value) {
+    mark_modified();
+    if (storage == EMazeStorage::bytes) {
+        rng::fill(items, value);
+        return;
+    }
+    packed.fill_walls(value == MazeObject::wall);
+    packed.fill_slow(value == MazeObject::slow);
+    // only a single start and finish can be represented
+    from = value == MazeObject::start ? 0 : cell_count();
+    to = value == MazeObject::finish ? 0 : cell_count();
+}
 
-    using raw_t = std::underlying_type_t<MazeObject>;
-    rng::transform(std::istream_iterator<raw_t>(file), std::istream_iterator<raw_t>(), maze.items.begin(), [](raw_t v) {
-        return static_cast<MazeObject>(v);
+void Maze::set_storage(EMazeStorage new_storage) {
+    if (new_storage == storage) {
+        return;
+    }
+    const auto count = cell_count();
+    if (new_storage == EMazeStorage::packed) {
+        // `from` and `to` are only maintained by callers in bytes storage, make sure they point at real tiles
+        if (from >= count || items[from] != MazeObject::start) {
+            from = size_t(rng::find(items, MazeObject::start) - items.begin());
+        }
+        if (to >= count || items[to] != MazeObject::finish) {
+            to = size_t(rng::find(items, MazeObject::finish) - items.begin());
+        }
+        packed = PackedCells(width, height);
+        for (size_t y = 0; y < height; ++y) {
+            for (size_t x = 0; x < width; ++x) {
+                const auto cell = items[util::coords_to_idx(x, y, width)];
+                packed.set_wall(x, y, cell == MazeObject::wall);
+                packed.set_slow(x, y, cell == MazeObject::slow);
+            }
+        }
+        items.clear();
+        items.shrink_to_fit();
+    } else {
+        items.resize(count);
+        for (size_t index = 0; index < count; ++index) {
+            items[index] = get_cell(index);
+        }
+        packed = PackedCells();
+    }
+    storage = new_storage;
+}
+
+void Maze::mark_modified() {
+    revision = ++s_last_revision;
+}
+
+bool Maze::has_slow_tiles() const {
+    if (storage == EMazeStorage::bytes) {
+        return rng::find(items, MazeObject::slow) != items.end();
+    }
+    if (!packed.has_slow_layer()) {
+        return false;
+    }
+    const auto* slow = packed.slow_row(0);
+    return std::any_of(slow, slow + packed.layer_size(), [](PackedCells::Word word) {
+        return word != 0;
     });
-    auto start_it = rng::find(maze.items, MazeObject::start);
-    auto finish_it = rng::find(maze.items, MazeObject::finish);
-    // order of iterators in std::distance is relevant!
-    maze.from = static_cast<size_t>(std::distance(maze.items.begin(), start_it));
-    maze.to = static_cast<size_t>(std::distance(maze.items.begin(), finish_it));
-    return maze;
+}
+
+Maze Maze::load(const std::filesystem::path& path) {
+    if (maze_file::is_binary(path)) {
+        return maze_file::load_binary(path);
+    }
+    return maze_file::load_text(path);
 }
 
 void Maze::save(const std::filesystem::path& path) const {
+    if (path.extension() == maze_file::binary_extension) {
+        maze_file::save_binary(*this, path);
+        return;
+    }
     std::ofstream file(path, std::ios::out);
     file << width << ' ' << height << ' ';
     using raw_t = std::underlying_type_t<MazeObject>;
-    rng::transform(items, std::ostream_iterator<raw_t>(file), [](MazeObject v) {
+    auto cells = std::views::iota(size_t(0), cell_count()) | std::views::transform([this](size_t index) {
+        return get_cell(index);
+    });
+    rng::transform(cells, std::ostream_iterator<raw_t>(file), [](MazeObject v) {
         return static_cast<raw_t>(v);
     });
 }
 
-MazeObject& Maze::get_cell(const Node& node) {
-    auto idx = util::coords_to_idx(node.x, node.y, width);
-    return items[idx];
+Maze::CellRef Maze::get_cell(const Node& node) {
+    return { *this, util::coords_to_idx(node.x, node.y, width) };
+}
+
+MazeObject Maze::get_cell(const Node& node) const {
+    return get_cell(util::coords_to_idx(node.x, node.y, width));
+}
+
+MazeObject Maze::get_cell(size_t index) const {
+    if (storage == EMazeStorage::bytes) {
+        return items[index];
+    }
+    const auto [x, y] = util::idx_to_coords(index, width);
+    if (packed.is_wall(x, y)) {
+        return MazeObject::wall;
+    }
+    if (index == from) {
+        return MazeObject::start;
+    }
+    if (index == to) {
+        return MazeObject::finish;
+    }
+    return packed.is_slow(x, y) ? MazeObject::slow : MazeObject::space;
+}
+
+void Maze::set_cell(size_t index, MazeObject value) {
+    mark_modified();
+    if (storage == EMazeStorage::bytes) {
+        items[index] = value;
+        return;
+    }
+    const auto [x, y] = util::idx_to_coords(index, width);
+    packed.set_wall(x, y, value == MazeObject::wall);
+    packed.set_slow(x, y, value == MazeObject::slow);
+    // packed storage keeps start and finish only as indices, so writing them moves the old ones
+    if (value == MazeObject::start) {
+        from = index;
+    } else if (index == from) {
+        from = cell_count();
+    }
+    if (value == MazeObject::finish) {
+        to = index;
+    } else if (index == to) {
+        to = cell_count();
+    }
+}
+
+size_t Maze::cell_count() const {
+    return width * height;
+}
+
+Maze::NodeIndexer Maze::get_node_indexer() const {
+    return { width, height };
+}
+
+Maze::CompactNodeIndexer Maze::get_compact_node_indexer() const {
+    return { width, height };
+}
+
+bool Maze::fits_compact_nodes() const {
+    return width <= max_compact_side && height <= max_compact_side;
 }
 
 bool Maze::is_valid(const Node& node) const {
     return node.x < width && node.y < height;
 }
 
-std::vector<Maze::Node> Maze::get_neighboors(const Node& node) const {
+Maze::NeighboorList Maze::get_neighboors(const Node& node) const {
     return get_cross_neighboors(node);
 }
 
-std::vector<Maze::Node> Maze::get_cross_neighboors(const Node& node, size_t distance) const {
+Maze::NeighboorList Maze::get_cross_neighboors(const Node& node, size_t distance) const {
     auto [x, y] = node;
     std::array nodes_to_check = {
         Node{x + distance, y},
@@ -97,21 +233,15 @@ std::vector<Maze::Node> Maze::get_cross_neighboors(const Node& node, size_t dist
         Node{x - distance, y},
         Node{x, y - distance}
     };
-    std::vector<Node> res;
-    res.reserve(nodes_to_check.size());
-
+    NeighboorList res;
     rng::copy_if(nodes_to_check, std::back_inserter(res), [&](const Node& node) {
-        if (is_valid(node)) {
-            auto index = util::coords_to_idx(node.x, node.y, width);
-            return items[index] != MazeObject::wall;
-        }
-        return false;
+        return is_valid(node) && !is_wall(node);
     });
 
     return res;
 }
 
-std::vector<Maze::Node> Maze::get_sides_and_corners(const Node& node, bool corners_require_adjacent, size_t distance) const {
+Maze::NeighboorList Maze::get_sides_and_corners(const Node& node, bool corners_require_adjacent, size_t distance) const {
     auto [x, y] = node;
     /*
      * 7 -- 0 -- 1
@@ -131,13 +261,10 @@ std::vector<Maze::Node> Maze::get_sides_and_corners(const Node& node, bool corne
         Node{x - distance, y - distance}
     };
 
-    std::vector<Node> res;
-    res.reserve(nodes_to_check.size());
-
+    NeighboorList res;
     for (size_t i = 0; i < nodes_to_check.size(); ++i) {
         const auto& node = nodes_to_check[i];
-        const auto node_index = util::coords_to_idx(node.x, node.y, width);
-        if (!is_valid(node) || items[node_index] == MazeObject::wall) {
+        if (!is_valid(node) || is_wall(node)) {
             continue;
         }
         const bool is_corner = i % 2 == 1;
@@ -145,12 +272,10 @@ std::vector<Maze::Node> Maze::get_sides_and_corners(const Node& node, bool corne
             // check adjacent
             const auto prev_index_to_check = i - 1; // first corner has index 1, so no negative values
             const auto prev_node = nodes_to_check[prev_index_to_check];
-            const auto prev_index = util::coords_to_idx(prev_node.x, prev_node.y, width);
             const auto next_index_to_check = (i + 1) % nodes_to_check.size();
             const auto next_node = nodes_to_check[next_index_to_check];
-            const auto next_index = util::coords_to_idx(next_node.x, next_node.y, width);
-            if (!is_valid(prev_node) || items[prev_index] == MazeObject::wall
-                || !is_valid(next_node) || items[next_index] == MazeObject::wall) {
+            if (!is_valid(prev_node) || is_wall(prev_node)
+                || !is_valid(next_node) || is_wall(next_node)) {
                 continue;
             }
         }
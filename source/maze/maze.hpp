@@ -5,12 +5,20 @@
 #include <cstdint>
 #include <cstdlib>
 #include <filesystem>
+#include <util/static_vector.hpp>
+#include "packed_cells.hpp"
 
 
 enum class MazeObject : uint8_t {
     space, wall, start, finish, slow
 };
 
+// bytes: one MazeObject per cell in `items`
+// packed: `packed` bit layers, start and finish exist only as `from` and `to`
+enum class EMazeStorage : uint8_t {
+    bytes, packed
+};
+
 struct Maze {
     struct Node { 
         size_t x;
@@ -27,25 +35,139 @@ struct Maze {
         auto operator<=>(const Node&) const = default;
     };
 
-    Maze(size_t width, size_t height, MazeObject default_tile = MazeObject::space);
+    // Node in 4 bytes instead of 16, for searches and logs that keep many of them.
+    // Holds coordinates below max_compact_side, converts to Node implicitly and back explicitly
+    struct CompactNode {
+        uint16_t x;
+        uint16_t y;
+
+        CompactNode() = default;
+        CompactNode(uint16_t x, uint16_t y) : x(x), y(y) {}
+        explicit CompactNode(const Node& node) : x(uint16_t(node.x)), y(uint16_t(node.y)) {}
+
+        operator Node() const {
+            return {x, y};
+        }
+
+        auto operator<=>(const CompactNode&) const = default;
+    };
+    static constexpr size_t max_compact_side = size_t(1) << 16;
+
+    // Dense row-major slot of a cell, usable as algos::NodeIndexer
+    struct NodeIndexer {
+        size_t width;
+        size_t height;
+
+        size_t operator()(const Node& node) const {
+            return node.y * width + node.x;
+        }
+
+        size_t size() const {
+            return width * height;
+        }
+
+        Node node(size_t slot) const {
+            return {slot % width, slot / width};
+        }
+    };
+
+    // Same slots for compact nodes
+    struct CompactNodeIndexer {
+        size_t width;
+        size_t height;
+
+        size_t operator()(const CompactNode& node) const {
+            return size_t(node.y) * width + node.x;
+        }
+
+        size_t size() const {
+            return width * height;
+        }
+
+        CompactNode node(size_t slot) const {
+            return {uint16_t(slot % width), uint16_t(slot / width)};
+        }
+    };
+
+    // at most 8 neighboors (sides and corners), stored inline so queries never allocate
+    using NeighboorList = util::StaticVector<Node, 8>;
+    using CompactNeighboorList = util::StaticVector<CompactNode, 8>;
+
+    // Reference to a single cell, valid for any storage kind
+    class CellRef {
+        Maze& m_maze;
+        size_t m_index;
+
+    public:
+        CellRef(Maze& maze, size_t index) : m_maze(maze), m_index(index) {}
+        CellRef(const CellRef&) = default;
+
+        operator MazeObject() const {
+            return m_maze.get_cell(m_index);
+        }
+
+        CellRef& operator=(MazeObject value) {
+            m_maze.set_cell(m_index, value);
+            return *this;
+        }
+
+        CellRef& operator=(const CellRef& other) {
+            return *this = MazeObject(other);
+        }
+
+        bool operator==(MazeObject value) const {
+            return MazeObject(*this) == value;
+        }
+
+        bool operator==(const CellRef& other) const {
+            return MazeObject(*this) == MazeObject(other);
+        }
+    };
+
+    Maze(size_t width, size_t height, MazeObject default_tile = MazeObject::space, EMazeStorage storage = EMazeStorage::bytes);
 
     size_t width;
     size_t height;
     size_t from;
     size_t to;
+    EMazeStorage storage;
+    // cells of `bytes` storage, empty otherwise
     std::vector<MazeObject> items;
+    // cells of `packed` storage, empty otherwise
+    PackedCells packed;
+    // Changes on every edit made through Maze methods, copies share it.
+    // Lets caches built from the cells notice edits. Direct writes to `items` are not tracked.
+    uint64_t revision;
     
     static Maze load(const std::filesystem::path&);
     static void add_random_start_finish(Maze&);
     void add_slow_tiles(double change_probability);
     void resize(size_t new_width, size_t new_height);
+    void fill(MazeObject value);
+    // converts cells to another storage kind, keeping `from` and `to`
+    void set_storage(EMazeStorage new_storage);
+    void mark_modified();
+    bool has_slow_tiles() const;
 
     void save(const std::filesystem::path&) const;
-    MazeObject& get_cell(const Node& node);
-    std::vector<Node> get_neighboors(const Node& node) const;
-    std::vector<Node> get_cross_neighboors(const Node& node, size_t distance = 1) const;
-    std::vector<Node> get_sides_and_corners(const Node& node, bool corners_require_adjacent, size_t distance = 1) const;
+    CellRef get_cell(const Node& node);
+    MazeObject get_cell(const Node& node) const;
+    MazeObject get_cell(size_t index) const;
+    void set_cell(size_t index, MazeObject value);
+    size_t cell_count() const;
+    NodeIndexer get_node_indexer() const;
+    CompactNodeIndexer get_compact_node_indexer() const;
+    // whether every cell has a CompactNode
+    bool fits_compact_nodes() const;
+    NeighboorList get_neighboors(const Node& node) const;
+    NeighboorList get_cross_neighboors(const Node& node, size_t distance = 1) const;
+    NeighboorList get_sides_and_corners(const Node& node, bool corners_require_adjacent, size_t distance = 1) const;
 
     bool is_valid(const Node& node) const;
+    bool is_wall(const Node& node) const {
+        return storage == EMazeStorage::bytes
+            ? items[node.y * width + node.x] == MazeObject::wall
+            : packed.is_wall(node.x, node.y);
+    }
 };
 
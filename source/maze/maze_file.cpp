@@ -0,0 +1,238 @@
+#include "maze_file.hpp"
+
+#include <util/util.hpp>
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#if (defined(__unix__) || defined(__APPLE__)) && !defined(__EMSCRIPTEN__)
+#define MAZE_FILE_USE_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace rng = std::ranges;
+
+
+namespace maze_file {
+    namespace {
+        // Whole file contents, memory mapped where possible.
+        // `owner` keeps the memory alive and can be shared with zero-copy views.
+        struct FileBytes {
+            const char* data = nullptr;
+            size_t size = 0;
+            std::shared_ptr<const void> owner;
+        };
+
+        std::runtime_error file_error(const std::filesystem::path& path, const char* what) {
+            return std::runtime_error("\"" + path.string() + "\": " + what);
+        }
+
+        FileBytes read_file(const std::filesystem::path& path) {
+            size_t size = 0;
+            if (!util::to_size(std::filesystem::file_size(path), size)) {
+                throw file_error(path, "file is too big");
+            }
+            if (size == 0) {
+                return {};
+            }
+#ifdef MAZE_FILE_USE_MMAP
+            const int descriptor = ::open(path.c_str(), O_RDONLY);
+            if (descriptor < 0) {
+                throw file_error(path, "can not open file");
+            }
+            void* address = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+            ::close(descriptor);
+            if (address == MAP_FAILED) {
+                throw file_error(path, "can not map file");
+            }
+            std::shared_ptr<const void> owner(address, [size](const void* mapped) {
+                ::munmap(const_cast<void*>(mapped), size);
+            });
+            return { static_cast<const char*>(address), size, std::move(owner) };
+#else
+            // word buffer keeps packed layers aligned just like a mapping would
+            auto buffer = std::make_shared<std::vector<PackedCells::Word>>((size + sizeof(PackedCells::Word) - 1) / sizeof(PackedCells::Word));
+            std::ifstream file(path, std::ios::in | std::ios::binary);
+            file.read(reinterpret_cast<char*>(buffer->data()), std::streamsize(size));
+            if (!file) {
+                throw file_error(path, "can not read file");
+            }
+            const auto* data = reinterpret_cast<const char*>(buffer->data());
+            return { data, size, std::move(buffer) };
+#endif
+        }
+
+        // false if the product does not fit in size_t, sizes read from a file can be anything
+        bool multiply(size_t first, size_t second, size_t& product) {
+            if (first != 0 && second > std::numeric_limits<size_t>::max() / first) {
+                return false;
+            }
+            product = first * second;
+            return true;
+        }
+
+        bool is_space(char c) {
+            return c == ' ' || (c >= '\t' && c <= '\r');
+        }
+    }
+
+    bool is_binary(const std::filesystem::path& path) {
+        std::ifstream file(path, std::ios::in | std::ios::binary);
+        std::array<char, 4> magic{};
+        file.read(magic.data(), std::streamsize(magic.size()));
+        return file && magic == binary_magic;
+    }
+
+    Maze load_binary(const std::filesystem::path& path) {
+        auto file = read_file(path);
+        Header header;
+        if (file.size < sizeof(header)) {
+            throw file_error(path, "file is too small for a binary maze");
+        }
+        std::memcpy(&header, file.data, sizeof(header));
+        if (header.magic != binary_magic) {
+            throw file_error(path, "not a binary maze file");
+        }
+        if (header.version != binary_version) {
+            throw file_error(path, "unsupported binary maze version");
+        }
+        // converted before any check, or a truncated value could pass them
+        size_t width = 0;
+        size_t height = 0;
+        if (!util::to_size(header.width, width) || !util::to_size(header.height, height)) {
+            throw file_error(path, "maze dimensions are too big");
+        }
+        const char* cells = file.data + sizeof(header);
+        const auto cells_size = file.size - sizeof(header);
+        size_t cell_count = 0;
+        // rows of packed layers are rounded up to whole words, which must not wrap around either
+        if (!multiply(width, height, cell_count) || width > std::numeric_limits<size_t>::max() - PackedCells::word_bits) {
+            throw file_error(path, "maze dimensions are too big");
+        }
+        // cell_count itself stands for no start or finish, like in mazes loaded from text without them
+        size_t from = 0;
+        size_t to = 0;
+        if (!util::to_size(header.from, from) || !util::to_size(header.to, to) || from > cell_count || to > cell_count) {
+            throw file_error(path, "start or finish outside of the maze");
+        }
+
+        if (header.storage == EMazeStorage::bytes) {
+            if (cells_size < cell_count) {
+                throw file_error(path, "truncated cells");
+            }
+            Maze maze(width, height);
+            std::memcpy(maze.items.data(), cells, maze.items.size());
+            if (rng::any_of(maze.items, [](MazeObject cell) { return cell > MazeObject::slow; })) {
+                throw file_error(path, "unknown cell kind");
+            }
+            maze.from = from;
+            maze.to = to;
+            return maze;
+        }
+        if (header.storage != EMazeStorage::packed) {
+            throw file_error(path, "unknown storage kind");
+        }
+
+        size_t layer_size = 0;
+        size_t layers_bytes = 0;
+        const size_t layer_count = header.has_slow_layer ? 2 : 1;
+        if (!multiply(PackedCells::words_per_row(width), height, layer_size)
+            || !multiply(layer_size, layer_count * sizeof(PackedCells::Word), layers_bytes)) {
+            throw file_error(path, "maze dimensions are too big");
+        }
+        if (cells_size < layers_bytes) {
+            throw file_error(path, "truncated cells");
+        }
+        const auto* walls = reinterpret_cast<const PackedCells::Word*>(cells);
+        const auto* slow = header.has_slow_layer ? walls + layer_size : nullptr;
+        // whole-word scans count on zero bits past the row end, like in layers PackedCells fills itself
+        const auto tail_bits = width % PackedCells::word_bits;
+        if (tail_bits != 0) {
+            const auto row_words = PackedCells::words_per_row(width);
+            const auto padding = ~((PackedCells::Word(1) << tail_bits) - 1);
+            // last words of all rows, the slow layer right after the wall one
+            for (size_t last_word = row_words - 1; last_word < layer_size * layer_count; last_word += row_words) {
+                if ((walls[last_word] & padding) != 0) {
+                    throw file_error(path, "nonzero padding bits after a row");
+                }
+            }
+        }
+
+        Maze maze(0, 0, MazeObject::space, EMazeStorage::packed);
+        maze.width = width;
+        maze.height = height;
+        maze.from = from;
+        maze.to = to;
+        maze.packed = PackedCells::view(width, height, walls, slow, std::move(file.owner));
+        return maze;
+    }
+
+    Maze load_text(const std::filesystem::path& path) {
+        const auto file = read_file(path);
+        const char* current = file.data;
+        const char* end = file.data + file.size;
+        auto skip_spaces = [&] {
+            while (current != end && is_space(*current)) {
+                ++current;
+            }
+        };
+
+        size_t width = 0;
+        size_t height = 0;
+        skip_spaces();
+        current = std::from_chars(current, end, width).ptr;
+        skip_spaces();
+        current = std::from_chars(current, end, height).ptr;
+
+        Maze maze(width, height);
+        for (auto& cell : maze.items) {
+            skip_spaces();
+            if (current == end) {
+                break;
+            }
+            cell = static_cast<MazeObject>(*current++);
+        }
+
+        auto start_it = rng::find(maze.items, MazeObject::start);
+        auto finish_it = rng::find(maze.items, MazeObject::finish);
+        // order of iterators in std::distance is relevant!
+        maze.from = static_cast<size_t>(std::distance(maze.items.begin(), start_it));
+        maze.to = static_cast<size_t>(std::distance(maze.items.begin(), finish_it));
+        return maze;
+    }
+
+    void save_binary(const Maze& maze, const std::filesystem::path& path) {
+        Header header{};
+        header.magic = binary_magic;
+        header.version = binary_version;
+        header.storage = maze.storage;
+        header.has_slow_layer = maze.storage == EMazeStorage::packed && maze.packed.has_slow_layer() ? 1 : 0;
+        header.width = maze.width;
+        header.height = maze.height;
+        header.from = maze.from;
+        header.to = maze.to;
+
+        std::ofstream file(path, std::ios::out | std::ios::binary);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        if (maze.storage == EMazeStorage::bytes) {
+            file.write(reinterpret_cast<const char*>(maze.items.data()), std::streamsize(maze.items.size()));
+            return;
+        }
+        const auto layer_bytes = std::streamsize(maze.packed.layer_size() * sizeof(PackedCells::Word));
+        file.write(reinterpret_cast<const char*>(maze.packed.wall_row(0)), layer_bytes);
+        if (header.has_slow_layer) {
+            file.write(reinterpret_cast<const char*>(maze.packed.slow_row(0)), layer_bytes);
+        }
+    }
+}
+
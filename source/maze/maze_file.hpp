@@ -0,0 +1,44 @@
+#pragma once
+
+#include "maze.hpp"
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+
+
+// Maze file formats.
+//
+// Text: "<width> <height> " followed by one raw MazeObject byte per cell.
+//
+// Binary (version 1): Header, then cells, numbers in native byte order.
+//   bytes storage:  width * height MazeObject bytes
+//   packed storage: wall layer, then slow layer if `has_slow_layer`,
+//                   each PackedCells::layer_size() words, rows padded to whole words
+// The header size keeps packed layers 8-byte aligned, so they are used straight from a memory mapped file.
+namespace maze_file {
+    inline constexpr std::array<char, 4> binary_magic = { 'A', 'V', 'M', 'Z' };
+    inline constexpr uint32_t binary_version = 1;
+    // Maze::save writes the binary format for paths with this extension
+    inline constexpr const char* binary_extension = ".bmaze";
+
+    struct Header {
+        std::array<char, 4> magic;
+        uint32_t version;
+        EMazeStorage storage;
+        uint8_t has_slow_layer;
+        std::array<uint8_t, 6> reserved;
+        uint64_t width;
+        uint64_t height;
+        uint64_t from;
+        uint64_t to;
+    };
+    static_assert(sizeof(Header) == 48 && sizeof(Header) % alignof(PackedCells::Word) == 0);
+
+    bool is_binary(const std::filesystem::path&);
+    // packed mazes are returned as zero-copy views into the mapped file
+    Maze load_binary(const std::filesystem::path&);
+    Maze load_text(const std::filesystem::path&);
+    void save_binary(const Maze&, const std::filesystem::path&);
+}
+
@@ -0,0 +1,157 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <utility>
+
+#include "maze.hpp"
+
+
+// Move rules of a maze as types, so searches are compiled for one of them and call it directly.
+// Each policy gives the same cells in the same order as the Maze method it mirrors.
+namespace neighboorhood {
+    namespace detail {
+        // Calls `visitor` with a check of whether a cell is inside the maze and not a wall,
+        // storage kind is looked at once instead of for every cell
+        template<typename Visitor>
+        decltype(auto) with_free_check(const Maze& maze, Visitor&& visitor) {
+            if (maze.storage == EMazeStorage::bytes) {
+                return visitor([&](size_t x, size_t y) {
+                    return x < maze.width && y < maze.height && maze.items[y * maze.width + x] != MazeObject::wall;
+                });
+            }
+            return visitor([&](size_t x, size_t y) {
+                return x < maze.width && y < maze.height && !maze.packed.is_wall(x, y);
+            });
+        }
+
+        // distances between cells along both axes, coordinates are unsigned
+        inline std::pair<double, double> offset(const Maze::Node& from, const Maze::Node& to) {
+            return {
+                from.x > to.x ? double(from.x - to.x) : double(to.x - from.x),
+                from.y > to.y ? double(from.y - to.y) : double(to.y - from.y)
+            };
+        }
+
+        template<bool CornersRequireAdjacent>
+        struct Diag8 {
+            static constexpr bool allows_diagonals = true;
+            static constexpr bool corners_require_adjacent = CornersRequireAdjacent;
+
+            // Cost of the cheapest way on an empty maze with side moves costing 1: octile distance,
+            // Chebyshev distance when corners cost 1 too. A corner costing over 2 is passed by two side moves
+            static double open_distance(const Maze::Node& from, const Maze::Node& to, double corner_cost) {
+                const auto [dx, dy] = offset(from, to);
+                const auto corners = std::min(dx, dy);
+                return std::min(corner_cost, 2.0) * corners + std::max(dx, dy) - corners;
+            }
+
+            static Maze::NeighboorList get(const Maze& maze, const Maze::Node& node) {
+                const auto [x, y] = node;
+                // same order as Maze::get_sides_and_corners, corners have odd indices
+                const std::array<Maze::Node, 8> around = {
+                    Maze::Node{x, y - 1},
+                    Maze::Node{x + 1, y - 1},
+                    Maze::Node{x + 1, y},
+                    Maze::Node{x + 1, y + 1},
+                    Maze::Node{x, y + 1},
+                    Maze::Node{x - 1, y + 1},
+                    Maze::Node{x - 1, y},
+                    Maze::Node{x - 1, y - 1}
+                };
+                return with_free_check(maze, [&](const auto& is_free) {
+                    std::array<bool, 8> free;
+                    for (size_t i = 0; i < around.size(); ++i) {
+                        free[i] = is_free(around[i].x, around[i].y);
+                    }
+                    Maze::NeighboorList res;
+                    for (size_t i = 0; i < around.size(); ++i) {
+                        if (!free[i]) {
+                            continue;
+                        }
+                        if constexpr (CornersRequireAdjacent) {
+                            if (i % 2 == 1 && (!free[i - 1] || !free[(i + 1) % around.size()])) {
+                                continue;
+                            }
+                        }
+                        res.push_back(around[i]);
+                    }
+                    return res;
+                });
+            }
+        };
+    }
+
+    // Side moves only, like Maze::get_cross_neighboors
+    struct Cross4 {
+        static constexpr bool allows_diagonals = false;
+        static constexpr bool corners_require_adjacent = true;
+
+        // Cost of the cheapest way on an empty maze with moves costing 1: Manhattan distance
+        static double open_distance(const Maze::Node& from, const Maze::Node& to, double) {
+            const auto [dx, dy] = detail::offset(from, to);
+            return dx + dy;
+        }
+
+        static Maze::NeighboorList get(const Maze& maze, const Maze::Node& node) {
+            const auto [x, y] = node;
+            const std::array<Maze::Node, 4> around = {
+                Maze::Node{x + 1, y},
+                Maze::Node{x, y + 1},
+                Maze::Node{x - 1, y},
+                Maze::Node{x, y - 1}
+            };
+            return detail::with_free_check(maze, [&](const auto& is_free) {
+                Maze::NeighboorList res;
+                for (const auto& neighboor : around) {
+                    if (is_free(neighboor.x, neighboor.y)) {
+                        res.push_back(neighboor);
+                    }
+                }
+                return res;
+            });
+        }
+    };
+
+    // Sides and corners, a corner needs both sides it passes by to be free
+    using Diag8Strict = detail::Diag8<true>;
+    // Sides and corners, corners may be cut
+    using Diag8Loose = detail::Diag8<false>;
+
+    // Policy bound to a maze, usable as algos::NeighboorsGetter
+    template<typename Policy>
+    struct Getter {
+        const Maze* maze;
+
+        Maze::NeighboorList operator()(const Maze::Node& node) const {
+            return Policy::get(*maze, node);
+        }
+    };
+
+    // Same for searches over Maze::CompactNode, the maze has to fit them
+    template<typename Policy>
+    struct CompactGetter {
+        const Maze* maze;
+
+        Maze::CompactNeighboorList operator()(const Maze::CompactNode& node) const {
+            Maze::CompactNeighboorList res;
+            for (const auto& neighboor : Policy::get(*maze, node)) {
+                res.push_back(Maze::CompactNode(neighboor));
+            }
+            return res;
+        }
+    };
+
+    // Calls `visitor` with the policy matching the settings, so the choice is made once rather than on every expansion
+    template<typename Visitor>
+    decltype(auto) dispatch(bool allow_diagonals, bool corners_require_adjacent, Visitor&& visitor) {
+        if (!allow_diagonals) {
+            return visitor(Cross4{});
+        }
+        if (corners_require_adjacent) {
+            return visitor(Diag8Strict{});
+        }
+        return visitor(Diag8Loose{});
+    }
+}
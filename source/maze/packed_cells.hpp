@@ -0,0 +1,183 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+
+
+// Bit-packed cell storage: one bit per cell for walls plus a second one-bit layer for slow tiles,
+// which is only allocated once the first slow tile is set.
+// Start and finish are not stored here, Maze keeps them as indices.
+// Every row starts at a word boundary and padding bits past the row end are always zero,
+// so bitwise kernels can process 64 cells of a row at once.
+class PackedCells {
+public:
+    using Word = uint64_t;
+    static constexpr size_t word_bits = 64;
+
+    PackedCells() = default;
+    PackedCells(size_t width, size_t height)
+        : m_width(width)
+        , m_height(height)
+        , m_words_per_row(words_per_row(width))
+        , m_walls(m_words_per_row * height, 0) {}
+
+    // Read-only view of layers owned by someone else, e.g. a memory mapped file.
+    // `owner` is kept alive while the view is used, the first modification copies layers into own memory.
+    // `slow` may be nullptr when there are no slow tiles.
+    static PackedCells view(size_t width, size_t height, const Word* walls, const Word* slow, std::shared_ptr<const void> owner) {
+        PackedCells cells;
+        cells.m_width = width;
+        cells.m_height = height;
+        cells.m_words_per_row = words_per_row(width);
+        cells.m_walls_view = walls;
+        cells.m_slow_view = slow;
+        cells.m_owner = std::move(owner);
+        return cells;
+    }
+
+    static size_t words_per_row(size_t width) {
+        return (width + word_bits - 1) / word_bits;
+    }
+
+    size_t words_per_row() const {
+        return m_words_per_row;
+    }
+
+    size_t layer_size() const {
+        return m_words_per_row * m_height;
+    }
+
+    bool is_view() const {
+        return m_owner != nullptr;
+    }
+
+    bool is_wall(size_t x, size_t y) const {
+        return test(walls(), x, y);
+    }
+
+    bool is_slow(size_t x, size_t y) const {
+        const auto* slow_layer = slow();
+        return slow_layer != nullptr && test(slow_layer, x, y);
+    }
+
+    bool has_slow_layer() const {
+        return slow() != nullptr;
+    }
+
+    void set_wall(size_t x, size_t y, bool value) {
+        detach();
+        assign(m_walls.data(), x, y, value);
+    }
+
+    void set_slow(size_t x, size_t y, bool value) {
+        detach();
+        if (m_slow.empty()) {
+            if (!value) {
+                return;
+            }
+            m_slow.assign(layer_size(), 0);
+        }
+        assign(m_slow.data(), x, y, value);
+    }
+
+    // fills every cell of a layer, keeping padding bits zero
+    void fill_walls(bool value) {
+        detach();
+        fill(m_walls, value);
+    }
+
+    void fill_slow(bool value) {
+        detach();
+        if (!value) {
+            m_slow.clear();
+            m_slow.shrink_to_fit();
+            return;
+        }
+        m_slow.assign(layer_size(), 0);
+        fill(m_slow, value);
+    }
+
+    const Word* wall_row(size_t y) const {
+        return walls() + y * m_words_per_row;
+    }
+
+    // nullptr when there are no slow tiles
+    const Word* slow_row(size_t y) const {
+        const auto* slow_layer = slow();
+        return slow_layer == nullptr ? nullptr : slow_layer + y * m_words_per_row;
+    }
+
+    // memory owned by this object, views do not count
+    size_t memory_usage() const {
+        return (m_walls.capacity() + m_slow.capacity()) * sizeof(Word);
+    }
+
+private:
+    size_t m_width = 0;
+    size_t m_height = 0;
+    size_t m_words_per_row = 0;
+    std::vector<Word> m_walls;
+    std::vector<Word> m_slow;
+
+    // set only for views
+    std::shared_ptr<const void> m_owner;
+    const Word* m_walls_view = nullptr;
+    const Word* m_slow_view = nullptr;
+
+    const Word* walls() const {
+        return m_owner ? m_walls_view : m_walls.data();
+    }
+
+    const Word* slow() const {
+        if (m_owner) {
+            return m_slow_view;
+        }
+        return m_slow.empty() ? nullptr : m_slow.data();
+    }
+
+    void detach() {
+        if (!m_owner) {
+            return;
+        }
+        m_walls.assign(m_walls_view, m_walls_view + layer_size());
+        if (m_slow_view != nullptr) {
+            m_slow.assign(m_slow_view, m_slow_view + layer_size());
+        }
+        m_walls_view = nullptr;
+        m_slow_view = nullptr;
+        m_owner.reset();
+    }
+
+    static Word bit(size_t x) {
+        return Word(1) << (x % word_bits);
+    }
+
+    size_t word_index(size_t x, size_t y) const {
+        return y * m_words_per_row + x / word_bits;
+    }
+
+    bool test(const Word* layer, size_t x, size_t y) const {
+        return (layer[word_index(x, y)] & bit(x)) != 0;
+    }
+
+    void assign(Word* layer, size_t x, size_t y, bool value) {
+        auto& word = layer[word_index(x, y)];
+        word = value ? (word | bit(x)) : (word & ~bit(x));
+    }
+
+    void fill(std::vector<Word>& layer, bool value) {
+        if (!value) {
+            std::fill(layer.begin(), layer.end(), Word(0));
+            return;
+        }
+        const auto tail_bits = m_width % word_bits;
+        const Word last_word = tail_bits == 0 ? ~Word(0) : bit(tail_bits) - 1;
+        for (size_t i = 0; i < layer.size(); ++i) {
+            layer[i] = (i + 1) % m_words_per_row == 0 ? last_word : ~Word(0);
+        }
+    }
+};
+
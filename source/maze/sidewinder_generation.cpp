@@ -47,7 +47,7 @@ Maze generate_sidewinder(size_t width, size_t height, float group_prob) {
                 maze.get_cell({break_point, h + 1}) = MazeObject::space;
                 group_start = w + 2;
             }
-            auto& cur = maze.get_cell({w, h});
+            auto cur = maze.get_cell({w, h});
             if (cur == MazeObject::wall) {
                 cur = MazeObject::space;
             }
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+
+namespace util {
+    // Vector with inline fixed-capacity storage, never touches the heap.
+    // Capacity is not checked on push_back, callers must know their upper bound.
+    // Items past size() are left uninitialized, so making an empty one costs nothing.
+    template<typename T, size_t Capacity>
+    class StaticVector {
+        std::array<T, Capacity> m_items;
+        size_t m_size = 0;
+
+    public:
+        using value_type = T;
+        using iterator = T*;
+        using const_iterator = const T*;
+
+        void push_back(const T& item) {
+            m_items[m_size++] = item;
+        }
+
+        void clear() {
+            m_size = 0;
+        }
+
+        size_t size() const {
+            return m_size;
+        }
+
+        bool empty() const {
+            return m_size == 0;
+        }
+
+        static constexpr size_t capacity() {
+            return Capacity;
+        }
+
+        T& operator[](size_t index) {
+            return m_items[index];
+        }
+
+        const T& operator[](size_t index) const {
+            return m_items[index];
+        }
+
+        T* begin() {
+            return m_items.data();
+        }
+
+        T* end() {
+            return m_items.data() + m_size;
+        }
+
+        const T* begin() const {
+            return m_items.data();
+        }
+
+        const T* end() const {
+            return m_items.data() + m_size;
+        }
+    };
+}
+
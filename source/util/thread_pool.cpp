@@ -0,0 +1,73 @@
+#include "thread_pool.hpp"
+
+
+namespace util {
+    ThreadPool::ThreadPool(size_t thread_count) {
+        for (size_t worker = 1; worker < thread_count; ++worker) {
+            m_workers.emplace_back([this, worker] { worker_loop(worker); });
+        }
+    }
+
+    ThreadPool::~ThreadPool() {
+        {
+            std::lock_guard lock(m_mutex);
+            m_stop = true;
+        }
+        m_job_ready.notify_all();
+        for (auto& thread : m_workers) {
+            thread.join();
+        }
+    }
+
+    void ThreadPool::run(const std::function<void(size_t)>& job) {
+        {
+            std::lock_guard lock(m_mutex);
+            m_job = &job;
+            m_running = m_workers.size();
+            m_error = nullptr;
+            ++m_generation;
+        }
+        m_job_ready.notify_all();
+        run_job(0, job);
+
+        std::unique_lock lock(m_mutex);
+        m_job_done.wait(lock, [this] { return m_running == 0; });
+        m_job = nullptr;
+        if (m_error) {
+            std::rethrow_exception(m_error);
+        }
+    }
+
+    void ThreadPool::worker_loop(size_t worker) {
+        size_t last_generation = 0;
+        while (true) {
+            const std::function<void(size_t)>* job = nullptr;
+            {
+                std::unique_lock lock(m_mutex);
+                m_job_ready.wait(lock, [&] { return m_stop || m_generation != last_generation; });
+                if (m_stop) {
+                    return;
+                }
+                last_generation = m_generation;
+                job = m_job;
+            }
+            run_job(worker, *job);
+            {
+                std::lock_guard lock(m_mutex);
+                --m_running;
+            }
+            m_job_done.notify_one();
+        }
+    }
+
+    void ThreadPool::run_job(size_t worker, const std::function<void(size_t)>& job) {
+        try {
+            job(worker);
+        } catch (...) {
+            std::lock_guard lock(m_mutex);
+            if (!m_error) {
+                m_error = std::current_exception();
+            }
+        }
+    }
+}
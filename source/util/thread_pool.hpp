@@ -0,0 +1,69 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+namespace util {
+    // Fixed set of worker threads running one job at a time, for level-synchronous parallel algorithms.
+    // The calling thread takes part in every job, so a pool of size 1 starts no threads at all.
+    class ThreadPool {
+    public:
+        explicit ThreadPool(size_t thread_count = std::thread::hardware_concurrency());
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        // number of workers, the calling thread included
+        size_t size() const {
+            return m_workers.size() + 1;
+        }
+
+        // Calls `job(worker)` once on every worker, the calling thread is worker 0.
+        // Returns when all of them are done. The first exception thrown by a worker is rethrown here.
+        void run(const std::function<void(size_t)>& job);
+
+        // Splits [0, count) into chunks of `chunk_size` handed out to workers on demand,
+        // calls `body(worker, begin, end)` for each of them.
+        template<typename Body>
+        void for_each_chunk(size_t count, size_t chunk_size, const Body& body) {
+            if (size() == 1 || count <= chunk_size) {
+                body(size_t(0), size_t(0), count);
+                return;
+            }
+            std::atomic<size_t> next_chunk = 0;
+            run([&](size_t worker) {
+                while (true) {
+                    const auto begin = next_chunk.fetch_add(chunk_size, std::memory_order_relaxed);
+                    if (begin >= count) {
+                        return;
+                    }
+                    body(worker, begin, std::min(begin + chunk_size, count));
+                }
+            });
+        }
+
+    private:
+        std::vector<std::thread> m_workers;
+        std::mutex m_mutex;
+        std::condition_variable m_job_ready;
+        std::condition_variable m_job_done;
+        const std::function<void(size_t)>* m_job = nullptr;
+        // incremented for every job, so workers never run the same one twice
+        size_t m_generation = 0;
+        size_t m_running = 0;
+        bool m_stop = false;
+        std::exception_ptr m_error;
+
+        void worker_loop(size_t worker);
+        void run_job(size_t worker, const std::function<void(size_t)>& job);
+    };
+}
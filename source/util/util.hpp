@@ -1,6 +1,11 @@
 #pragma once
 
+#include <concepts>
+#include <cstddef>
+#include <limits>
 #include <string_view>
+#include <type_traits>
+#include <utility>
 
 
 namespace util {
@@ -34,5 +39,19 @@ constexpr std::pair<size_t, size_t> idx_to_coords(size_t index, size_t width) {
     return { index % width, index / width };
 }
 
+// false if `value` does not fit in size_t, like 64 bit values read from a file where size_t is 32 bit
+template<std::unsigned_integral T>
+constexpr bool to_size(T value, size_t& size) {
+    if constexpr (std::is_same_v<T, size_t>) {
+        size = value;
+    } else {
+        if (value > std::numeric_limits<size_t>::max()) {
+            return false;
+        }
+        size = static_cast<size_t>(value);
+    }
+    return true;
+}
+
 } // namespace util
 
@@ -20,11 +20,13 @@ const Grid::Style Grid::s_default_style = {
     .used_color = al_map_rgb(0, 200, 200),
     .discovered_color = al_map_rgb(0, 100, 100),
     .last_used_color = al_map_rgb(200, 0, 0),
-    .brush_hover_color = al_map_rgb(50, 200, 200)
+    .brush_hover_color = al_map_rgb(50, 200, 200),
+    .distance_near_color = al_map_rgb(250, 230, 110),
+    .distance_far_color = al_map_rgb(40, 50, 150)
 };
 
 Grid::Grid(const Maze& maze, float vis_width, float vis_height, Style style)
-    : m_grid(maze.items.size())
+    : m_grid(maze.cell_count())
     , m_width(maze.width)
     , m_height(maze.height)
     , m_bitmap(int(vis_height), int(vis_width))
@@ -33,7 +35,7 @@ Grid::Grid(const Maze& maze, float vis_width, float vis_height, Style style)
     , m_style(std::move(style))
 { 
     for (size_t i = 0; i < m_grid.size(); ++i) {
-        m_grid[i].color = m_style.color_map[maze.items[i]];
+        m_grid[i].color = m_style.color_map[maze.get_cell(i)];
     }
     recalculate_visual_parameters();
 }
@@ -71,6 +73,13 @@ Grid::Style& Grid::style() {
     return m_style;
 }
 
+ALLEGRO_COLOR Grid::distance_color(float fraction) const {
+    const auto t = std::clamp(fraction, 0.0f, 1.0f);
+    const auto& near = m_style.distance_near_color;
+    const auto& far = m_style.distance_far_color;
+    return al_map_rgb_f(near.r + (far.r - near.r) * t, near.g + (far.g - near.g) * t, near.b + (far.b - near.b) * t);
+}
+
 void Grid::set_dimentions(float width, float height) {
     m_visual_screen_width = width;
     m_visual_screen_height = height;
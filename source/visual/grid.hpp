@@ -24,6 +24,9 @@ namespace visual {
             ALLEGRO_COLOR discovered_color;
             ALLEGRO_COLOR last_used_color;
             ALLEGRO_COLOR brush_hover_color;
+            // ends of the gradient distance maps are drawn with
+            ALLEGRO_COLOR distance_near_color;
+            ALLEGRO_COLOR distance_far_color;
         };
 
         const static ColorMap s_default_color_map;
@@ -63,6 +66,8 @@ namespace visual {
 
         const Style& style() const;
         Style& style();
+        // blend of distance colors of the style, `fraction` 0 is near and 1 is far
+        ALLEGRO_COLOR distance_color(float fraction) const;
 
         void set_dimentions(float width, float height);
         std::pair<float, float> get_dimentions() const;